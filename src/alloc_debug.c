@@ -0,0 +1,53 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "alloc_debug.h"
+
+#ifdef ALLOC_DEBUG
+
+/* The calling thread's own counter, and the one it is charged to (NULL for its own) */
+static _Thread_local atomic_size_t own = 0;
+static _Thread_local atomic_size_t* charged = NULL;
+
+/* The real allocators, as renamed by -Wl,--wrap */
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+/* The counter the calling thread's allocations go to */
+atomic_size_t* alloc_counter(void)
+{
+  return charged ? charged : &own;
+}
+
+void* __wrap_malloc(size_t size)
+{
+  atomic_fetch_add_explicit(alloc_counter(),1,memory_order_relaxed);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size)
+{
+  atomic_fetch_add_explicit(alloc_counter(),1,memory_order_relaxed);
+  return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  atomic_fetch_add_explicit(alloc_counter(),1,memory_order_relaxed);
+  return __real_realloc(ptr, size);
+}
+
+/* Charge the calling thread's allocations to counter (NULL for its own) */
+void alloc_charge(atomic_size_t* counter)
+{
+  charged = counter;
+}
+
+/* Number of allocation calls counted so far by the calling thread's counter */
+size_t alloc_count(void)
+{
+  return atomic_load(alloc_counter());
+}
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * Allocation accounting for debug builds (make ALLOC_DEBUG=1): the
+ * linker routes malloc, calloc and realloc through counting wrappers,
+ * so that the main loop can check that it does not allocate. Each
+ * thread counts on its own, except that the workers of a thread pool
+ * are charged to the thread whose scan they run, so that a run's
+ * check covers its parallel evaluation but not the other runs.
+ */
+
+#ifndef ALLOC_DEBUG_H
+#define ALLOC_DEBUG_H
+
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#ifdef ALLOC_DEBUG
+/* The counter the calling thread's allocations go to */
+atomic_size_t* alloc_counter(void);
+
+/* Charge the calling thread's allocations to counter (NULL for its own) */
+void alloc_charge(atomic_size_t* counter);
+
+/* Number of allocation calls counted so far by the calling thread's counter */
+size_t alloc_count(void);
+#endif
+
+#endif
@@ -0,0 +1,336 @@
+#include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
+
+#ifdef USE_GLPK
+/* Uses GNU Linear Programming Kit to cross-check the solver */
+#include <glpk.h> 
+#endif
+
+#include "assign.h"
+
+#define INF LONG_MAX
+
+/* Allocate workspace for up to max_rows rows, max_cols columns and max_edges pairs */
+void assign_init(assign_ws* ws, int max_rows, int max_cols, int max_edges)
+{
+  int ncols = max_cols + max_rows;
+  ws->max_rows = max_rows;
+  ws->max_cols = max_cols;
+  ws->max_edges = max_edges;
+  ws->rows = ws->cols = ws->nedges = 0;
+
+  ws->erow = malloc(max_edges*sizeof(int));
+  ws->ecol = malloc(max_edges*sizeof(int));
+  ws->ecost = malloc(max_edges*sizeof(long));
+
+  ws->start = malloc((max_rows+1)*sizeof(int));
+  ws->adj_col = malloc(max_edges*sizeof(int));
+  ws->adj_cost = malloc(max_edges*sizeof(long));
+  ws->dflt = malloc(max_rows*sizeof(long));
+
+  ws->u = malloc(max_rows*sizeof(long));
+  ws->v = malloc(ncols*sizeof(long));
+  ws->row_match = malloc(max_rows*sizeof(int));
+  ws->col_match = malloc(ncols*sizeof(int));
+
+  ws->dist = malloc(ncols*sizeof(long));
+  ws->prev = malloc(ncols*sizeof(int));
+  ws->done = calloc(ncols,sizeof(char));
+  ws->touched = malloc(ncols*sizeof(int));
+  /* each relaxation pushes at most one heap entry */
+  ws->heap_key = malloc((max_edges+max_rows)*sizeof(long));
+  ws->heap_col = malloc((max_edges+max_rows)*sizeof(int));
+}
+
+/* Free memory */
+void assign_free(assign_ws* ws)
+{
+  free(ws->erow);
+  free(ws->ecol);
+  free(ws->ecost);
+  free(ws->start);
+  free(ws->adj_col);
+  free(ws->adj_cost);
+  free(ws->dflt);
+  free(ws->u);
+  free(ws->v);
+  free(ws->row_match);
+  free(ws->col_match);
+  free(ws->dist);
+  free(ws->prev);
+  free(ws->done);
+  free(ws->touched);
+  free(ws->heap_key);
+  free(ws->heap_col);
+}
+
+/* Start a new instance with the given number of rows and columns */
+void assign_reset(assign_ws* ws, int rows, int cols)
+{
+  assert(rows <= ws->max_rows && cols <= ws->max_cols);
+  ws->rows = rows;
+  ws->cols = cols;
+  ws->nedges = 0;
+}
+
+/* Set the cost of assigning row to its default column */
+void assign_default(assign_ws* ws, int row, long cost)
+{
+  ws->dflt[row] = cost;
+}
+
+/* Allow assigning row to col at the given cost */
+void assign_add(assign_ws* ws, int row, int col, long cost)
+{
+  assert(ws->nedges < ws->max_edges && row < ws->rows && col < ws->cols);
+  ws->erow[ws->nedges] = row;
+  ws->ecol[ws->nedges] = col;
+  ws->ecost[ws->nedges] = cost;
+  ws->nedges++;
+}
+
+/* Binary min-heap with lazy deletion */
+static void heap_push(assign_ws* ws, int* len, long key, int col)
+{
+  int i = (*len)++;
+  while (i > 0 && ws->heap_key[(i-1)/2] > key){
+    ws->heap_key[i] = ws->heap_key[(i-1)/2];
+    ws->heap_col[i] = ws->heap_col[(i-1)/2];
+    i = (i-1)/2;
+  }
+  ws->heap_key[i] = key;
+  ws->heap_col[i] = col;
+}
+
+static int heap_pop(assign_ws* ws, int* len)
+{
+  int col = ws->heap_col[0];
+  long key = ws->heap_key[--(*len)];
+  int last = ws->heap_col[*len];
+  int i = 0;
+  while (2*i+1 < *len){
+    int c = 2*i+1;
+    if (c+1 < *len && ws->heap_key[c+1] < ws->heap_key[c]) c++;
+    if (ws->heap_key[c] >= key) break;
+    ws->heap_key[i] = ws->heap_key[c];
+    ws->heap_col[i] = ws->heap_col[c];
+    i = c;
+  }
+  ws->heap_key[i] = key;
+  ws->heap_col[i] = last;
+  return col;
+}
+
+/* Relax the columns of row x, which is at distance d */
+static void relax_row(assign_ws* ws, int x, long d, int* heap_len, int* ntouched)
+{
+  int p;
+  int dcol = ws->cols + x;
+  for (p=ws->start[x]; p<=ws->start[x+1]; p++){
+    /* the last entry is the default column of x */
+    int j = (p < ws->start[x+1]) ? ws->adj_col[p] : dcol;
+    long c = (p < ws->start[x+1]) ? ws->adj_cost[p] : ws->dflt[x];
+    long nd;
+    if (ws->done[j]) continue;
+    nd = d + c - ws->u[x] - ws->v[j];
+    if (ws->dist[j] == INF) ws->touched[(*ntouched)++] = j;
+    if (nd < ws->dist[j]){
+      ws->dist[j] = nd;
+      ws->prev[j] = x;
+      heap_push(ws,heap_len,nd,j);
+    }
+  }
+}
+
+/* 
+ * Solve the instance, returning the minimum total cost; afterwards
+ * assign_column(ws,i) is the column of row i, or -1 for its default
+ */
+long assign_solve(assign_ws* ws)
+{
+  int i, j, r, p;
+  int ncols = ws->cols + ws->rows;
+  long total = 0;
+
+  /* group edges by row (counting sort) */
+  for (i=0; i<=ws->rows; i++) ws->start[i] = 0;
+  for (p=0; p<ws->nedges; p++) ws->start[ws->erow[p]+1]++;
+  for (i=0; i<ws->rows; i++) ws->start[i+1] += ws->start[i];
+  for (p=0; p<ws->nedges; p++){
+    int q = ws->start[ws->erow[p]]++;
+    ws->adj_col[q] = ws->ecol[p];
+    ws->adj_cost[q] = ws->ecost[p];
+  }
+  for (i=ws->rows; i>0; i--) ws->start[i] = ws->start[i-1];
+  ws->start[0] = 0;
+
+  /* feasible initial potentials: u[i] is the cheapest cost of row i */
+  for (j=0; j<ncols; j++){
+    ws->v[j] = 0;
+    ws->col_match[j] = -1;
+    ws->dist[j] = INF;
+  }
+  for (i=0; i<ws->rows; i++){
+    ws->u[i] = ws->dflt[i];
+    for (p=ws->start[i]; p<ws->start[i+1]; p++){
+      if (ws->adj_cost[p] < ws->u[i]) ws->u[i] = ws->adj_cost[p];
+    }
+    ws->row_match[i] = -1;
+  }
+
+  /* add the rows one at a time along shortest augmenting paths */
+  for (r=0; r<ws->rows; r++){
+    int heap_len = 0, ntouched = 0;
+    int jfree = -1;
+    long D;
+
+    relax_row(ws,r,0,&heap_len,&ntouched);
+    while (heap_len > 0){
+      j = heap_pop(ws,&heap_len);
+      if (ws->done[j]) continue;
+      ws->done[j] = 1;
+      if (ws->col_match[j] < 0){
+	jfree = j;
+	break;
+      }
+      relax_row(ws,ws->col_match[j],ws->dist[j],&heap_len,&ntouched);
+    }
+    /* the default column of r is always reachable */
+    assert(jfree >= 0);
+    D = ws->dist[jfree];
+
+    /* update potentials of the scanned nodes, keeping reduced costs >= 0 */
+    ws->u[r] += D;
+    for (i=0; i<ntouched; i++){
+      j = ws->touched[i];
+      if (ws->done[j] && j != jfree){
+	ws->v[j] -= D - ws->dist[j];
+	ws->u[ws->col_match[j]] += D - ws->dist[j];
+      }
+    }
+
+    /* augment along the path ending in jfree */
+    j = jfree;
+    for (;;){
+      int x = ws->prev[j];
+      int jnext = ws->row_match[x];
+      ws->row_match[x] = j;
+      ws->col_match[j] = x;
+      if (x == r) break;
+      j = jnext;
+    }
+
+    /* reset the Dijkstra state of the touched columns */
+    for (i=0; i<ntouched; i++){
+      ws->dist[ws->touched[i]] = INF;
+      ws->done[ws->touched[i]] = 0;
+    }
+  }
+
+  /* total cost of the assignment */
+  for (i=0; i<ws->rows; i++){
+    j = ws->row_match[i];
+    if (j >= ws->cols) total += ws->dflt[i];
+    else {
+      for (p=ws->start[i]; ws->adj_col[p] != j; p++);
+      total += ws->adj_cost[p];
+    }
+  }
+  return total;
+}
+
+/* Column assigned to row by the last solve (-1 for the default) */
+int assign_column(const assign_ws* ws, int row)
+{
+  return (ws->row_match[row] >= ws->cols) ? -1 : ws->row_match[row];
+}
+
+#ifdef USE_GLPK
+/*
+ * Minimum total cost of the current instance, computed by solving the
+ * LP relaxation with GLPK (the constraint matrix is totally
+ * unimodular, so the LP optimum is integral). Column 0 of each row in
+ * the LP is its default, which may be taken by any number of rows.
+ */
+long assign_lp_cost(const assign_ws* ws)
+{
+  int i,j,p,el;
+  int m = ws->rows, l = ws->cols;
+  long cost;
+  int* row_idx, *col_idx;
+  double* constr_mat;
+
+  /* LP problem structure */
+  glp_prob *lp;
+
+  /* Parameters for simplex solver */
+  glp_smcp solver_params;
+
+  /* ************************** */
+  /* Create LP problem instance */
+  /* ************************** */
+  glp_init_smcp(&solver_params);
+  solver_params.msg_lev = GLP_MSG_ERR;
+  solver_params.meth = GLP_PRIMAL;
+
+  lp = glp_create_prob();
+  glp_set_obj_dir(lp,GLP_MIN);
+  glp_add_cols(lp,m*(l+1));
+  glp_add_rows(lp,m+l); 
+
+  /* there are exactly 2lm+m nonzero entries in constraint matrix */
+  row_idx = calloc(1+2*l*m+m,sizeof(int));
+  col_idx = calloc(1+2*l*m+m,sizeof(int));
+  constr_mat = calloc(1+2*l*m+m,sizeof(double));
+
+  /* ***************************** */
+  /* Compute the constraint matrix */
+  /* ***************************** */    
+  el=1;
+  /* First m constraints: each row is assigned exactly one column;
+     pairs that were not added cost as much as the default */
+  for (i=0; i<m; i++){
+    for (j=0; j<=l; j++){      
+      int idx = i*(l+1) + (j+1);
+      glp_set_obj_coef(lp,idx,(double)ws->dflt[i]);	
+      glp_set_col_bnds(lp,idx,GLP_DB,0.0,1.0);
+      row_idx[el] = i+1;
+      col_idx[el] = idx;
+      constr_mat[el] = 1.0;
+      el++;
+    }
+    glp_set_row_bnds(lp,i+1,GLP_FX,1.0,1.0);
+  }
+  for (p=0; p<ws->nedges; p++){
+    glp_set_obj_coef(lp,ws->erow[p]*(l+1) + ws->ecol[p] + 2,(double)ws->ecost[p]);
+  }
+  /* Next l constraints: column j has at most one row assigned to it */
+  for (j=0; j<l; j++){
+    for (i=0; i<m; i++){
+      int idx = i*(l+1) + (j+2);
+      row_idx[el] = m+j+1;
+      col_idx[el] = idx;
+      constr_mat[el] = 1.0;
+      el++;
+    }
+    glp_set_row_bnds(lp,m+j+1,GLP_UP,0,1.0);
+  }
+  glp_load_matrix(lp,el-1,&row_idx[0],&col_idx[0],&constr_mat[0]);
+
+  /* ************ */
+  /* Solve the LP */
+  /* ************ */    
+  glp_simplex(lp,&solver_params);
+  cost = (long)(glp_get_obj_val(lp) + (glp_get_obj_val(lp) < 0 ? -0.5 : 0.5));
+
+  /* ************************* */
+  /* Clean up after the solver */
+  /* ************************* */
+  glp_delete_prob(lp);
+  free(row_idx);
+  free(col_idx);
+  free(constr_mat);
+  return cost;
+}
+#endif
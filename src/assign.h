@@ -0,0 +1,78 @@
+/*
+ * Sparse min-cost assignment solver
+ *
+ * Every row must be assigned either to one of the columns (each column
+ * takes at most one row) or to its own private default column. The
+ * cost of the default is given for each row, and only the (row,column)
+ * pairs that are cheaper than the default need to be added. Solved by
+ * successive shortest paths (Hungarian method with Dijkstra on reduced
+ * costs), using workspace that is allocated once and reused.
+ */
+
+#ifndef ASSIGN_H
+#define ASSIGN_H
+
+#include <stdlib.h>
+
+typedef struct {
+  int max_rows, max_cols, max_edges;
+  int rows, cols, nedges;
+
+  /* edges as added */
+  int*  erow;
+  int*  ecol;
+  long* ecost;
+
+  /* edges grouped by row, default cost of each row */
+  int*  start;
+  int*  adj_col;
+  long* adj_cost;
+  long* dflt;
+
+  /* potentials; column cols+i is the default column of row i */
+  long* u;
+  long* v;
+
+  /* row_match[i] is the column of row i, col_match[j] the row of column j */
+  int* row_match;
+  int* col_match;
+
+  /* Dijkstra state */
+  long* dist;
+  int*  prev;
+  char* done;
+  int*  touched;
+  long* heap_key;
+  int*  heap_col;
+} assign_ws;
+
+/* Allocate workspace for up to max_rows rows, max_cols columns and max_edges pairs */
+void assign_init(assign_ws* ws, int max_rows, int max_cols, int max_edges);
+
+/* Free memory */
+void assign_free(assign_ws* ws);
+
+/* Start a new instance with the given number of rows and columns */
+void assign_reset(assign_ws* ws, int rows, int cols);
+
+/* Set the cost of assigning row to its default column */
+void assign_default(assign_ws* ws, int row, long cost);
+
+/* Allow assigning row to col at the given cost */
+void assign_add(assign_ws* ws, int row, int col, long cost);
+
+/* 
+ * Solve the instance, returning the minimum total cost; afterwards
+ * assign_column(ws,i) is the column of row i, or -1 for its default
+ */
+long assign_solve(assign_ws* ws);
+
+/* Column assigned to row by the last solve (-1 for the default) */
+int assign_column(const assign_ws* ws, int row);
+
+#ifdef USE_GLPK
+/* Minimum total cost of the current instance computed by GLPK (for cross-checking) */
+long assign_lp_cost(const assign_ws* ws);
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include "bitslice.h"
+#include "chromosome.h"
+#include "graph.h"
+
+/* Initialize an empty view for problem type on the graph G */
+void bs_init(bitslice* bs, prob_type type, const graph_data* G)
+{
+  assert(type == CVD || type == CD);
+  bs->type = type;
+  bs->V = calloc(G->n,sizeof(lane_t));
+  bs->E = calloc(G->m,sizeof(lane_t));
+  bs->S = calloc(type == CVD ? G->n : G->m,sizeof(lane_t));
+  bs->Vlist = malloc(G->n*sizeof(int));
+  bs->Elist = malloc(G->m*sizeof(int));
+  bs->Vlist_len = bs->Elist_len = 0;
+  bs->loaded = 0;
+}
+
+/* Free memory */
+void bs_free(bitslice* bs)
+{
+  free(bs->V);
+  free(bs->E);
+  free(bs->S);
+  free(bs->Vlist);
+  free(bs->Elist);
+}
+
+/* Load chromosome chr into every lane of mask */
+void bs_load(bitslice* bs, const chromosome* chr, lane_t mask)
+{
+  int i, j, inside = 0;
+  for (i=0; i<chr->cached_Vlist_len; i++){
+    int v = chr->cached_Vlist[i];
+    if (!bs->V[v]) bs->Vlist[bs->Vlist_len++] = v;
+    bs->V[v] |= mask;
+    if (bs->type == CVD && ps_read(&chr->S,v)){
+      bs->S[v] |= mask;
+      inside++;
+    }
+  }
+  for (i=0; i<chr->cached_Elist_len; i++){
+    int e = chr->cached_Elist[i];
+    if (!bs->E[e]) bs->Elist[bs->Elist_len++] = e;
+    bs->E[e] |= mask;
+    if (bs->type == CD && ps_read(&chr->S,e)){
+      bs->S[e] |= mask;
+      inside++;
+    }
+  }
+  for (j=0; j<BS_LANES; j++){
+    if ((mask >> j) & 1) bs->inside[j] = inside;
+  }
+  bs->loaded |= mask;
+}
+
+/* Flip element i of S in a lane (elements outside G[V] are ignored) */
+void bs_flip(bitslice* bs, int lane, int i)
+{
+  lane_t bit = (lane_t)1 << lane;
+  lane_t in = (bs->type == CVD) ? bs->V[i] : bs->E[i];
+  if (!(in & bit)) return;
+  bs->S[i] ^= bit;
+  bs->inside[lane] += (bs->S[i] & bit) ? 1 : -1;
+}
+
+/* Lanes in which G[V] - S has no P3 through a vertex of V */
+static lane_t bs_cvd_feasible(const bitslice* bs, const graph_data* G, lane_t bad)
+{
+  int i, j;
+  for (i=0; i<bs->Vlist_len; i++){
+    int v = bs->Vlist[i];
+    lane_t av = bs->V[v] & ~bs->S[v] & ~bad;
+    if (!av) continue;
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int u = src(G->p3_vlist[v][j]);
+      int w = snk(G->p3_vlist[v][j]);
+      bad |= av & (bs->V[u] & ~bs->S[u]) & (bs->V[w] & ~bs->S[w]);
+    }
+    if (bad == bs->loaded) return 0;
+  }
+  return bs->loaded & ~bad;
+}
+
+/* Lanes in which G[V] - S has no P3 through an edge of G[V] */
+static lane_t bs_cd_feasible(const bitslice* bs, const graph_data* G, lane_t bad)
+{
+  int i, j;
+  for (i=0; i<bs->Elist_len; i++){
+    int e = bs->Elist[i];
+    lane_t ae = bs->E[e] & ~bs->S[e] & ~bad;
+    if (!ae) continue;
+    for (j=0; j<G->p3_elist_len[e]; j++){
+      int f = G->p3_elist[e][j];
+      bad |= ae & bs->E[f] & ~bs->S[f];
+    }
+    for (j=0; j<G->triangle_elist_len[e]; j++){
+      int e1 = src(G->triangle_elist[e][j]);
+      int e2 = snk(G->triangle_elist[e][j]);
+      bad |= ae & ((bs->E[e1] & ~bs->S[e1]) ^ (bs->E[e2] & ~bs->S[e2]));
+    }
+    if (bad == bs->loaded) return 0;
+  }
+  return bs->loaded & ~bad;
+}
+
+/* Return the mask of loaded lanes that are feasible for budget k */
+lane_t bs_feasible(const bitslice* bs, const graph_data* G, int k)
+{
+  int j;
+  lane_t bad = 0;
+  /* lanes with more than k elements inside G[V] */
+  for (j=0; j<BS_LANES; j++){
+    if (((bs->loaded >> j) & 1) && bs->inside[j] > k) bad |= (lane_t)1 << j;
+  }
+  if (bs->type == CVD) return bs_cvd_feasible(bs,G,bad);
+  return bs_cd_feasible(bs,G,bad);
+}
+
+/* Empty the view, touching only the loaded elements */
+void bs_clear(bitslice* bs)
+{
+  int i;
+  for (i=0; i<bs->Vlist_len; i++){
+    bs->V[bs->Vlist[i]] = 0;
+    if (bs->type == CVD) bs->S[bs->Vlist[i]] = 0;
+  }
+  for (i=0; i<bs->Elist_len; i++){
+    bs->E[bs->Elist[i]] = 0;
+    if (bs->type == CD) bs->S[bs->Elist[i]] = 0;
+  }
+  bs->Vlist_len = bs->Elist_len = 0;
+  bs->loaded = 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Bit-sliced (transposed) view of up to 64 chromosomes: one word per
+ * vertex / edge / solution element holding that element's membership
+ * across all lanes, so that one pass over the P3 lists evaluates
+ * every lane with plain AND/OR operations.
+ */
+
+#ifndef BITSLICE_H
+#define BITSLICE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "chromosome.h"
+#include "graph.h"
+#include "params.h"
+
+typedef uint64_t lane_t;
+#define BS_LANES 64
+
+/* mask of lanes 0,...,cnt-1 */
+#define bs_lanes(CNT) ((CNT) >= BS_LANES ? ~(lane_t)0 : (((lane_t)1 << (CNT)) - 1))
+
+/*
+ * V[v] lanes containing vertex v
+ * E[e] lanes containing edge e in G[V]
+ * S[i] lanes containing element i in S (only for elements inside G[V])
+ * Vlist / Elist the union of the loaded vertex / edge sets
+ * inside[j] |S & V| (CVD) or |S & E(G[V])| (CD) of lane j
+ */
+typedef struct {
+  prob_type type;
+  lane_t* V;
+  lane_t* E;
+  lane_t* S;
+  int* Vlist;
+  int  Vlist_len;
+  int* Elist;
+  int  Elist_len;
+  int  inside[BS_LANES];
+  lane_t loaded;
+} bitslice;
+
+/* Initialize an empty view for problem type on the graph G */
+void bs_init(bitslice* bs, prob_type type, const graph_data* G);
+
+/* Free memory */
+void bs_free(bitslice* bs);
+
+/* Load chromosome chr into every lane of mask */
+void bs_load(bitslice* bs, const chromosome* chr, lane_t mask);
+
+/* Flip element i of S in a lane (elements outside G[V] are ignored) */
+void bs_flip(bitslice* bs, int lane, int i);
+
+/* Return the mask of loaded lanes that are feasible for budget k */
+lane_t bs_feasible(const bitslice* bs, const graph_data* G, int k);
+
+/* Empty the view, touching only the loaded elements */
+void bs_clear(bitslice* bs);
+
+#endif
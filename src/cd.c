@@ -6,8 +6,63 @@
 #include "chromosome.h"
 #include "packed_set.h"
 #include "graph.h"
+#include "witness.h"
+#include "context.h"
+#include "parallel.h"
 #include "cd.h"
 
+/* Scratch space of the CD operators: repair edge sets and witnesses */
+struct cd_workspace {
+  /* A is the set of edges that cannot be deleted */
+  packed_set A;
+
+  /* D is the set of edges to delete */
+  packed_set D;
+
+  int* Dlist;
+
+  /* 
+   * Recently found P3s (e,f,g): edges e and f of G[V] - S with g not
+   * in G[V] - S, where g = -1 if the third side is not an edge of G
+   */
+  witness_cache witnesses;
+
+  /* P3 found by each thread of a scan, as for witnesses */
+  int found[PAR_MAX_THREADS][3];
+};
+
+/* Arguments of a scan for P3s in G[V] - S */
+struct cd_scan {
+  const chromosome* offspr;
+  context* ctx;
+};
+
+/* Allocate the scratch space of the CD operators for the graph G */
+struct cd_workspace* cd_workspace_create(const graph_data* G)
+{
+  struct cd_workspace* ws = malloc(sizeof(struct cd_workspace));
+  ps_init(&ws->A,G->m);
+  ps_init(&ws->D,G->m);
+  ws->Dlist = malloc(ps_capacity(&ws->D)*sizeof(int));
+  wc_clear(&ws->witnesses);
+  return ws;
+}
+
+/* Free the scratch space of the CD operators */
+void cd_workspace_destroy(struct cd_workspace* ws)
+{
+  ps_free(&ws->A);
+  ps_free(&ws->D);
+  free(ws->Dlist);
+  free(ws);
+}
+
+/* Statistics of the P3 witness cache */
+const witness_cache* cd_witnesses(const context* ctx)
+{
+  return &ctx->cd->witnesses;
+}
+
 /* Is edge in G[V] - S ? 
  * 
  * not in S
@@ -20,102 +75,233 @@ bool edge_in_graph(int edge, const chromosome* offspr, const graph_data* G)
     ps_read(&offspr->V,snk(G->edge_list[edge])); 
 }
 
-/* Determine if G[V] - S is a cluster graph */
-bool cd_feasible(const chromosome* offspr, const graph_data* G)
+/* 
+ * Scan the edges first, first+step, ... of G[V] - S for a P3 of
+ * G[V] - S, recording it in ws->found[first]
+ */
+static bool cd_scan_p3s(int first, int step, void* arg, const atomic_bool* stop)
 {
+  const struct cd_scan* sc = arg;
+  const chromosome* offspr = sc->offspr;
+  const graph_data* G = sc->ctx->G;
+  struct cd_workspace* ws = sc->ctx->cd;
   int i, j;
-  int count=0;
-  for (i=0; i<G->m; i++){
-    // Is this edge in S and G[V]?
-    if (ps_read(&offspr->S,i) && ps_read(&offspr->V,src(G->edge_list[i])) && ps_read(&offspr->V,snk(G->edge_list[i]))) count++;
-    if (count > G->k) return false; // More than k edges in S \cap G[V]
-    
-    if (edge_in_graph(i,offspr,G)) {
 
-      // go through p3 pairs of edge i and see if any of them are also in the graph
-      for (j=0; j<G->p3_elist_len[i]; j++){
-	if (edge_in_graph(G->p3_elist[i][j],offspr,G)){
-	  return false;
-	}	  
-      }
+  for (i=first; i<offspr->cached_Elist_len; i+=step){
+    int e = offspr->cached_Elist[i];
+    // Is this edge in S?
+    if (ps_read(&offspr->S,e)) continue;
+    if (atomic_load_explicit(stop,memory_order_relaxed)) return false;
 
-      // go through the triangles of edge i and see if only one of them is in the graph
-      for (j=0; j<G->triangle_elist_len[i]; j++){
-	int e1 = src(G->triangle_elist[i][j]);
-	int e2 = snk(G->triangle_elist[i][j]);
-	if (edge_in_graph(e1,offspr,G) != edge_in_graph(e2,offspr,G)){
-	  return false;
-	}
+    // go through p3 pairs of edge e and see if any of them are also in the graph
+    for (j=0; j<G->p3_elist_len[e]; j++){
+      if (edge_in_graph(G->p3_elist[e][j],offspr,G)){
+	ws->found[first][0] = e;
+	ws->found[first][1] = G->p3_elist[e][j];
+	ws->found[first][2] = -1;
+	return true;
+      }	  
+    }
+
+    // go through the triangles of edge e and see if only one of them is in the graph
+    for (j=0; j<G->triangle_elist_len[e]; j++){
+      int e1 = src(G->triangle_elist[e][j]);
+      int e2 = snk(G->triangle_elist[e][j]);
+      if (edge_in_graph(e1,offspr,G) != edge_in_graph(e2,offspr,G)){
+	ws->found[first][0] = e;
+	ws->found[first][1] = edge_in_graph(e1,offspr,G) ? e1 : e2;
+	ws->found[first][2] = edge_in_graph(e1,offspr,G) ? e2 : e1;
+	return true;
       }
     }
   }
-  return true;
+  return false;
 }
 
-/* Repair operator for CD */
-bool cd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, const graph_data* G)
+/* 
+ * Determine if G[V] - S is a cluster graph (scanning in parallel if
+ * the context has threads and V is large)
+ */
+bool cd_feasible(const chromosome* offspr, context* ctx)
 {
+  const graph_data* G = ctx->G;
+  struct cd_workspace* ws = ctx->cd;
+  struct cd_scan sc = { offspr, ctx };
+  atomic_bool never = false;
+  int i, t;
+  int count=0;
 
-  int i, j, len;
-  
-  /* A is the set of edges that cannot be deleted */
-  static packed_set A;
+  /* try the P3s that were found recently first */
+  ws->witnesses.lookups++;
+  for (i=0; i<ws->witnesses.len; i++){
+    int z = ws->witnesses.z[i];
+    if (edge_in_graph(ws->witnesses.x[i],offspr,G) && edge_in_graph(ws->witnesses.y[i],offspr,G) && (z < 0 || !edge_in_graph(z,offspr,G))) {
+      ws->witnesses.rejections++;
+      ws->witnesses.hits++;
+      return false;
+    }
+  }
 
-  static int* Alist;
-  
-  /* D is the set of edges to delete */
-  static packed_set D;
-  
-  /* Initialization flag */
-  static bool initialized = false;
+  /* only the edges of G[V] need to be checked, and at most k of them may be in S */
+  for (i=0; i<offspr->cached_Elist_len; i++){
+    if (ps_read(&offspr->S,offspr->cached_Elist[i]) && ++count > ctx->k) return false;
+  }
 
-  /* Initialize static data structures the first time repair is called */
-  if (!initialized){
-    ps_init(&A,G->m);
-    ps_init(&D,G->m);
-    Alist = malloc(ps_capacity(&A)*sizeof(int));
-    initialized = true;
+  if (ctx->pool && offspr->cached_Vlist_len >= PAR_MIN_VERTICES) t = par_any(ctx->pool,cd_scan_p3s,&sc);
+  else t = cd_scan_p3s(0,1,&sc,&never) ? 0 : -1;
+  if (t >= 0){
+    ws->witnesses.rejections++;
+    wc_store(&ws->witnesses,ws->found[t][0],ws->found[t][1],ws->found[t][2]);
+    return false;
   }
+  return true;
+}
 
+/* 
+ * Fitness of a mutant of a feasible parent: chr is the parent, of
+ * fitness rp and with ip edges of G[V] in S (-1 if unknown), after
+ * flipping the elements in flips. Only the P3s and triangles through
+ * the flipped edges can change, so only those are checked. Caches the
+ * fitness and budget count of chr.
+ */
+int cd_mutant_fitness(chromosome* chr, int rp, int ip, const int* flips, size_t nflips, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  size_t i;
+  int j, inside = ip;
 
+  chr->fitness = rp;
+  for (i=0; i<nflips; i++){
+    int e = flips[i];
+    bool in_GV = ps_read(&chr->V,src(G->edge_list[e])) && ps_read(&chr->V,snk(G->edge_list[e]));
+    if (ps_read(&chr->S,e)){
+      chr->fitness++;
+      if (ip >= 0 && in_GV) inside++;
+    }
+    else {
+      chr->fitness--;
+      if (ip >= 0 && in_GV) inside--;
+    }
+  }
+  if (ip < 0) {
+    inside = 0;
+    for (j=0; j<chr->cached_Elist_len; j++){
+      if (ps_read(&chr->S,chr->cached_Elist[j])) inside++;
+    }
+  }
+  if (inside > ctx->k) {
+    chr->fitness = FITNESS_INFEASIBLE;
+    return chr->fitness;
+  }
+
+  for (i=0; i<nflips; i++){
+    int e = flips[i];
+    if (!ps_read(&chr->V,src(G->edge_list[e])) || !ps_read(&chr->V,snk(G->edge_list[e]))) continue;
+    if (!ps_read(&chr->S,e)){
+      /* e is back in the graph: its P3s and half-present triangles */
+      for (j=0; j<G->p3_elist_len[e]; j++){
+	if (edge_in_graph(G->p3_elist[e][j],chr,G)){
+	  chr->fitness = FITNESS_INFEASIBLE;
+	  return chr->fitness;
+	}
+      }
+      for (j=0; j<G->triangle_elist_len[e]; j++){
+	if (edge_in_graph(src(G->triangle_elist[e][j]),chr,G) != edge_in_graph(snk(G->triangle_elist[e][j]),chr,G)){
+	  chr->fitness = FITNESS_INFEASIBLE;
+	  return chr->fitness;
+	}
+      }
+    }
+    else {
+      /* e left the graph: the other two edges of its triangles */
+      for (j=0; j<G->triangle_elist_len[e]; j++){
+	if (edge_in_graph(src(G->triangle_elist[e][j]),chr,G) && edge_in_graph(snk(G->triangle_elist[e][j]),chr,G)){
+	  chr->fitness = FITNESS_INFEASIBLE;
+	  return chr->fitness;
+	}
+      }
+    }
+  }
+  chr->inside = inside;
+  return chr->fitness;
+}
+
+/* 
+ * Repair operator for CD
+ *
+ * Returns the fitness of the repaired offspring if it is already
+ * known (and caches it in offspr), FITNESS_OVER_BUDGET (leaving
+ * offspr unrepaired) as soon as the repaired offspring would have
+ * more than k edges of G[V] in S, otherwise FITNESS_UNKNOWN
+ */
+int cd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct cd_workspace* ws = ctx->cd;
+
+  int i, j, len, inside;
+  
   /* If offspr is already feasible, success */
-  if (cd_feasible(offspr, G)) return true;
+  if (cd_feasible(offspr,ctx)) {
+    offspr->fitness = ps_popcount(&offspr->S);
+    return offspr->fitness;
+  }
   
   /* Determine set A = (x | y | template) - self.S */
-  ps_zero(&A);
-  ps_union(&A,x,y);
-  ps_union(&A,&A,t);
-  ps_subtract(&A,&offspr->S);
+  ps_union(&ws->A,x,y);
+  ps_union(&ws->A,&ws->A,t);
+  ps_subtract(&ws->A,&offspr->S);
 
-  
-  /* for each e in A, if there is an f in E(H)-A such that (e,f) is a P3 add f to z */
-  ps_zero(&D);
-  ps_contents(Alist,&len,&A);
-  for (i=0; i<len; i++){
-    if (!edge_in_graph(Alist[i],offspr,G)) continue;
-    for (j=0; j<G->p3_elist_len[Alist[i]]; j++){
-      int f = G->p3_elist[Alist[i]][j];
-      if (edge_in_graph(f,offspr,G) && !ps_read(&A,f)) {
-	ps_store(&D,f);
+  /* Edges of G[V] that are already in S count against the budget */
+  inside = 0;
+  for (i=0; i<offspr->cached_Elist_len; i++){
+    if (ps_read(&offspr->S,offspr->cached_Elist[i])) inside++;
+  }
+
+  /* 
+   * for each e in A, if there is an f in E(H)-A such that (e,f) is a
+   * P3 add f to D (only edges of G[V] can be in E(H)); each f is a
+   * new edge of S, so give up once the budget is exceeded
+   */
+  len = 0;
+  for (i=0; i<offspr->cached_Elist_len && inside + len <= ctx->k; i++){
+    int e = offspr->cached_Elist[i];
+    if (!ps_read(&ws->A,e)) continue;
+    for (j=0; j<G->p3_elist_len[e]; j++){
+      int f = G->p3_elist[e][j];
+      if (edge_in_graph(f,offspr,G) && !ps_read(&ws->A,f) && !ps_read(&ws->D,f)) {
+	ps_store(&ws->D,f);
+	ws->Dlist[len++] = f;
       }
     }
   }
+  if (inside + len > ctx->k){
+    for (i=0; i<len; i++) ps_clear(&ws->D,ws->Dlist[i]);
+    return FITNESS_OVER_BUDGET;
+  }
 
-  ps_union(&offspr->S,&offspr->S,&D);
+  /* S = S | D, clearing D for the next call */
+  for (i=0; i<len; i++){
+    chromosome_store(offspr,ws->Dlist[i]);
+    ps_clear(&ws->D,ws->Dlist[i]);
+  }
+  chromosome_invalidate(offspr);
     
-  return true;
+  return FITNESS_UNKNOWN;
 }
 
 /*
  * Create a template parent z for CD
  */
-void cd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, const graph_data* G)
+void cd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx)
 {
-  int e,f,i;
+  const graph_data* G = ctx->G;
+  int e,f,i,j;
   assert(p1->S.capacity == p2->S.capacity && p1->S.capacity == z->capacity);
   ps_zero(z);
   /* while there are P3s, take a P3 out */
-  for (e=0; e<G->m; e++){
+  for (j=0; j<offspr->cached_Elist_len; j++){
+    e = offspr->cached_Elist[j];
     if (edge_in_graph(e,offspr,G) && !ps_read(&p1->S,e) && !ps_read(&p2->S,e) && !ps_read(z,e)){
       for (i=0; i<G->p3_elist_len[e]; i++){
 	f = G->p3_elist[e][i];
@@ -129,3 +315,77 @@ void cd_template(packed_set* z, const chromosome* offspr, const chromosome* p1,
   }
 }
 
+/*
+ * Greedy clustering of G into cliques: take the unclustered vertex of
+ * largest degree as a pivot and grow a clique around it, always
+ * adding the candidate (an unclustered vertex adjacent to the whole
+ * clique) with the most neighbours among the other candidates.
+ * cluster[v] is set to the pivot of the clique of v.
+ */
+void cd_greedy_cliques(int* cluster, const graph_data* G)
+{
+  int* order = malloc(G->n*sizeof(int));
+  int* cand = malloc(G->n*sizeof(int));
+  /* candidate[u] marks the candidates, adjacent[u] the neighbours of
+     the vertex just added */
+  bool* candidate = calloc(G->n,sizeof(bool));
+  bool* adjacent = calloc(G->n,sizeof(bool));
+  int i, j, l, u, len;
+
+  vertices_by_degree(order,G);
+  for (i=0; i<G->n; i++) cluster[i] = -1;
+  for (i=0; i<G->n; i++){
+    int v = order[i];
+    if (cluster[v] >= 0) continue;
+    cluster[v] = v;
+    for (j=len=0; j<G->adj_list_len[v]; j++){
+      u = G->adj_list[v][j];
+      if (cluster[u] < 0){
+	cand[len++] = u;
+	candidate[u] = true;
+      }
+    }
+    while (len > 0){
+      int best = 0, most = -1;
+      for (j=0; j<len; j++){
+	int c = 0;
+	for (l=0; l<G->adj_list_len[cand[j]]; l++) c += candidate[G->adj_list[cand[j]][l]];
+	if (c > most){
+	  most = c;
+	  best = j;
+	}
+      }
+
+      /* add it, keeping only the candidates adjacent to it */
+      u = cand[best];
+      cluster[u] = v;
+      for (l=0; l<G->adj_list_len[u]; l++) adjacent[G->adj_list[u][l]] = true;
+      for (j=l=0; j<len; j++){
+	candidate[cand[j]] = false;
+	if (adjacent[cand[j]]) cand[l++] = cand[j];
+      }
+      len = l;
+      for (j=0; j<len; j++) candidate[cand[j]] = true;
+      for (l=0; l<G->adj_list_len[u]; l++) adjacent[G->adj_list[u][l]] = false;
+    }
+  }
+
+  free(order);
+  free(cand);
+  free(candidate);
+  free(adjacent);
+}
+
+/* Greedy CD solution H on all of G: delete the edges between cliques */
+void cd_greedy(packed_set* H, const graph_data* G)
+{
+  int* cluster = malloc(G->n*sizeof(int));
+  int i;
+
+  cd_greedy_cliques(cluster,G);
+  ps_zero(H);
+  for (i=0; i<G->m; i++){
+    if (cluster[src(G->edge_list[i])] != cluster[snk(G->edge_list[i])]) ps_store(H,i);
+  }
+  free(cluster);
+}
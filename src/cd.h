@@ -5,9 +5,17 @@
 #include "chromosome.h"
 #include "packed_set.h"
 #include "graph.h"
+#include "witness.h"
+#include "context.h"
 
-bool cd_feasible(const chromosome* offspr, const graph_data* G);
-bool cd_cluster_graph(const chromosome* offspr, const packed_set* A, const graph_data* G);
-bool cd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, const graph_data* G);
-void cd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, const graph_data* G);
+struct cd_workspace* cd_workspace_create(const graph_data* G);
+void cd_workspace_destroy(struct cd_workspace* ws);
+const witness_cache* cd_witnesses(const context* ctx);
+bool edge_in_graph(int edge, const chromosome* offspr, const graph_data* G);
+bool cd_feasible(const chromosome* offspr, context* ctx);
+int cd_mutant_fitness(chromosome* chr, int rp, int ip, const int* flips, size_t nflips, context* ctx);
+int cd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx);
+void cd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx);
+void cd_greedy_cliques(int* cluster, const graph_data* G);
+void cd_greedy(packed_set* H, const graph_data* G);
 #endif
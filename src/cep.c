@@ -0,0 +1,285 @@
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include "chromosome.h"
+#include "packed_set.h"
+#include "graph.h"
+#include "context.h"
+#include "cd.h"
+#include "cep.h"
+
+/*
+ * Cluster editing: S holds the edits, the edges 0..m-1 of G to delete
+ * and the indexed non-edges m..m+q-1 to insert (see index_nonedges),
+ * and H is G[V] with the edits of S inside V applied
+ */
+
+/* Scratch space of the CEP operators: component labelling and repair sets */
+struct cep_workspace {
+  /* Map V -> component of H (0 for vertices not yet labelled) */
+  int* comp;
+
+  /* csize[c] is the number of vertices in component c */
+  int* csize;
+
+  /* deg[v] is the degree of v in H */
+  int* deg;
+
+  /* queue of the breadth-first search */
+  int* queue;
+
+  /* A is the set of edits that are protected from repair */
+  packed_set A;
+
+  /* D is the set of edits that repair adds to S */
+  packed_set D;
+
+  int* Dlist;
+};
+
+/* Allocate the scratch space of the CEP operators for the graph G */
+struct cep_workspace* cep_workspace_create(const graph_data* G)
+{
+  struct cep_workspace* ws = malloc(sizeof(struct cep_workspace));
+  ws->comp = calloc(G->n,sizeof(int));
+  ws->csize = malloc(sizeof(int)*(G->n+1));
+  ws->deg = malloc(sizeof(int)*G->n);
+  ws->queue = malloc(sizeof(int)*G->n);
+  ps_init(&ws->A,G->m+G->q);
+  ps_init(&ws->D,G->m+G->q);
+  ws->Dlist = malloc(ps_capacity(&ws->D)*sizeof(int));
+  return ws;
+}
+
+/* Free the scratch space of the CEP operators */
+void cep_workspace_destroy(struct cep_workspace* ws)
+{
+  free(ws->comp);
+  free(ws->csize);
+  free(ws->deg);
+  free(ws->queue);
+  ps_free(&ws->A);
+  ps_free(&ws->D);
+  free(ws->Dlist);
+  free(ws);
+}
+
+/* Number of edits of S inside V (these count against the budget) */
+static int cep_inside(const chromosome* offspr)
+{
+  int i, inside = 0;
+  for (i=0; i<offspr->cached_Elist_len; i++){
+    if (ps_read(&offspr->S,offspr->cached_Elist[i])) inside++;
+  }
+  for (i=0; i<offspr->cached_Nlist_len; i++){
+    if (ps_read(&offspr->S,offspr->cached_Nlist[i])) inside++;
+  }
+  return inside;
+}
+
+/* 
+ * Determine if H is a cluster graph: label the components of H by
+ * breadth-first search, then check that every vertex is adjacent to
+ * all of its component
+ */
+bool cep_feasible(const chromosome* offspr, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct cep_workspace* ws = ctx->cep;
+  int i, j, c, head, tail;
+  bool is_cluster_graph = true;
+
+  if (cep_inside(offspr) > ctx->k) return false;
+
+  for (i=0,c=0; i<offspr->cached_Vlist_len; i++){
+    int v = offspr->cached_Vlist[i];
+    if (ws->comp[v]) continue;
+    ws->comp[v] = ++c;
+    ws->csize[c] = 0;
+    head = tail = 0;
+    ws->queue[tail++] = v;
+    while (head < tail){
+      int x = ws->queue[head++];
+      ws->csize[c]++;
+      ws->deg[x] = 0;
+      /* edges of G[V] that are not deleted */
+      for (j=0; j<G->adj_list_len[x]; j++){
+	int y = G->adj_list[x][j];
+	if (y != x && ps_read(&offspr->V,y) && !ps_read(&offspr->S,G->adj_elist[x][j])){
+	  ws->deg[x]++;
+	  if (!ws->comp[y]) {
+	    ws->comp[y] = c;
+	    ws->queue[tail++] = y;
+	  }
+	}
+      }
+      /* inserted non-edges */
+      for (j=0; j<G->nadj_list_len[x]; j++){
+	int y = G->nadj_list[x][j];
+	if (ps_read(&offspr->V,y) && ps_read(&offspr->S,G->m+G->nadj_elist[x][j])){
+	  ws->deg[x]++;
+	  if (!ws->comp[y]) {
+	    ws->comp[y] = c;
+	    ws->queue[tail++] = y;
+	  }
+	}
+      }
+    }
+  }
+
+  /* check degrees, clearing the labels for the next call */
+  for (i=0; i<offspr->cached_Vlist_len; i++){
+    int v = offspr->cached_Vlist[i];
+    if (ws->deg[v] != ws->csize[ws->comp[v]] - 1) is_cluster_graph = false;
+    ws->comp[v] = 0;
+  }
+  return is_cluster_graph;
+}
+
+/* 
+ * Repair operator for CEP
+ *
+ * Returns the fitness of the repaired offspring if it is already
+ * known (and caches it in offspr), FITNESS_OVER_BUDGET (leaving
+ * offspr unrepaired) as soon as the repaired offspring would have
+ * more than k edits inside V, otherwise FITNESS_UNKNOWN
+ */
+int cep_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct cep_workspace* ws = ctx->cep;
+
+  int i, j, len, inside;
+  
+  /* If offspr is already feasible, success */
+  if (cep_feasible(offspr,ctx)) {
+    offspr->fitness = ps_popcount(&offspr->S);
+    return offspr->fitness;
+  }
+  
+  /* Determine set A = (x | y | template) - self.S */
+  ps_union(&ws->A,x,y);
+  ps_union(&ws->A,&ws->A,t);
+  ps_subtract(&ws->A,&offspr->S);
+
+  /* Edits inside V that are already in S count against the budget */
+  inside = cep_inside(offspr);
+
+  /* 
+   * for each edge e in A, if there is an edge f of H not in A such
+   * that (e,f) is a P3 of H, close the P3 by inserting the non-edge
+   * if a parent inserted it, otherwise delete f; each is a new edit
+   * of S, so give up once the budget is exceeded
+   */
+  len = 0;
+  for (i=0; i<offspr->cached_Elist_len && inside + len <= ctx->k; i++){
+    int e = offspr->cached_Elist[i];
+    if (!ps_read(&ws->A,e)) continue;
+    for (j=0; j<G->p3_elist_len[e]; j++){
+      int f = G->p3_elist[e][j];
+      int g = G->m + G->p3_nlist[e][j];
+      if (edge_in_graph(f,offspr,G) && !ps_read(&offspr->S,g) && !ps_read(&ws->A,f) &&
+	  !ps_read(&ws->D,f) && !ps_read(&ws->D,g)) {
+	int d = ps_read(&ws->A,g) ? g : f;
+	ps_store(&ws->D,d);
+	ws->Dlist[len++] = d;
+      }
+    }
+  }
+  if (inside + len > ctx->k){
+    for (i=0; i<len; i++) ps_clear(&ws->D,ws->Dlist[i]);
+    return FITNESS_OVER_BUDGET;
+  }
+
+  /* S = S | D, clearing D for the next call */
+  for (i=0; i<len; i++){
+    chromosome_store(offspr,ws->Dlist[i]);
+    ps_clear(&ws->D,ws->Dlist[i]);
+  }
+  chromosome_invalidate(offspr);
+    
+  return FITNESS_UNKNOWN;
+}
+
+/*
+ * Create a template parent z for CEP
+ */
+void cep_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  int e,f,g,i,j;
+  assert(p1->S.capacity == p2->S.capacity && p1->S.capacity == z->capacity);
+  ps_zero(z);
+  /* while there are open P3s, take a P3 and its closing non-edge out */
+  for (j=0; j<offspr->cached_Elist_len; j++){
+    e = offspr->cached_Elist[j];
+    if (edge_in_graph(e,offspr,G) && !ps_read(&p1->S,e) && !ps_read(&p2->S,e) && !ps_read(z,e)){
+      for (i=0; i<G->p3_elist_len[e]; i++){
+	f = G->p3_elist[e][i];
+	g = G->m + G->p3_nlist[e][i];
+	if (edge_in_graph(f,offspr,G) && !ps_read(&offspr->S,g) &&
+	    !ps_read(&p1->S,f) && !ps_read(&p2->S,f) && !ps_read(z,f) &&
+	    !ps_read(&p1->S,g) && !ps_read(&p2->S,g) && !ps_read(z,g)){
+	  ps_store(z,e);
+	  ps_store(z,f);
+	  ps_store(z,g);
+	  break;
+	}
+      }      
+    }
+  }
+}
+
+/* Number of edits that turn G into the clusters given by cluster */
+static int cluster_cost(const int* cluster, const graph_data* G)
+{
+  int i, cost = 0;
+  for (i=0; i<G->m; i++){
+    if (cluster[src(G->edge_list[i])] != cluster[snk(G->edge_list[i])]) cost++;
+  }
+  for (i=0; i<G->q; i++){
+    if (cluster[src(G->nonedge_list[i])] == cluster[snk(G->nonedge_list[i])]) cost++;
+  }
+  return cost;
+}
+
+/*
+ * Greedy CEP solution H on all of G: the cheaper of pivot clustering
+ * (take the unclustered vertex of largest degree as a pivot and
+ * cluster it with its unclustered neighbours) and the cliques of
+ * cd_greedy_cliques, with the edges between clusters deleted and the
+ * non-edges inside them inserted. Two neighbours of a pivot close a
+ * P3 through it, so these non-edges are all indexed.
+ */
+void cep_greedy(packed_set* H, const graph_data* G)
+{
+  int* order = malloc(G->n*sizeof(int));
+  int* cluster = malloc(G->n*sizeof(int));
+  int* cliques = malloc(G->n*sizeof(int));
+  int i, j;
+
+  vertices_by_degree(order,G);
+  for (i=0; i<G->n; i++) cluster[i] = -1;
+  for (i=0; i<G->n; i++){
+    int v = order[i];
+    if (cluster[v] >= 0) continue;
+    cluster[v] = v;
+    for (j=0; j<G->adj_list_len[v]; j++){
+      if (cluster[G->adj_list[v][j]] < 0) cluster[G->adj_list[v][j]] = v;
+    }
+  }
+  cd_greedy_cliques(cliques,G);
+  if (cluster_cost(cliques,G) < cluster_cost(cluster,G)) memcpy(cluster,cliques,G->n*sizeof(int));
+
+  ps_zero(H);
+  for (i=0; i<G->m; i++){
+    if (cluster[src(G->edge_list[i])] != cluster[snk(G->edge_list[i])]) ps_store(H,i);
+  }
+  for (i=0; i<G->q; i++){
+    if (cluster[src(G->nonedge_list[i])] == cluster[snk(G->nonedge_list[i])]) ps_store(H,G->m+i);
+  }
+  free(order);
+  free(cluster);
+  free(cliques);
+}
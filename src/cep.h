@@ -0,0 +1,17 @@
+#ifndef CEP_H
+#define CEP_H
+
+#include <stdbool.h>
+#include "chromosome.h"
+#include "packed_set.h"
+#include "graph.h"
+#include "context.h"
+
+struct cep_workspace* cep_workspace_create(const graph_data* G);
+void cep_workspace_destroy(struct cep_workspace* ws);
+bool cep_feasible(const chromosome* offspr, context* ctx);
+int cep_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx);
+void cep_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx);
+void cep_greedy(packed_set* H, const graph_data* G);
+
+#endif
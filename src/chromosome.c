@@ -5,14 +5,23 @@
 
 #include "chromosome.h"
 #include "packed_set.h"
+#include "graph.h"
+#include "ttable.h"
 
-/* Initialize a chromosome with solution length len and n vertices */
-void chromosome_init(chromosome* chr, size_t len, size_t n)
+/* Initialize a chromosome with solution length len for the graph G */
+void chromosome_init(chromosome* chr, size_t len, const graph_data* G)
 {
   ps_init(&chr->S,len);
-  ps_init(&chr->V,n);
-  chr->cached_Vlist = malloc(n*sizeof(int));
+  ps_init(&chr->V,G->n);
+  chr->cached_Vlist = malloc(G->n*sizeof(int));
   chr->cached_Vlist_len = 0;
+  chr->cached_Elist = malloc(G->m*sizeof(int));
+  chr->cached_Elist_len = 0;
+  chr->cached_Nlist = malloc((G->q+1)*sizeof(int));
+  chr->cached_Nlist_len = 0;
+  chr->fitness = FITNESS_UNKNOWN;
+  chr->inside = -1;
+  chr->hash_S = chr->hash_V = 0;
 }
 
 /* Set this chromosome's subgraph to contain a single vertex */
@@ -22,6 +31,11 @@ void chromosome_seed(chromosome* chr, int vertex)
   ps_store(&chr->V,vertex);
   chr->cached_Vlist[0] = vertex;
   chr->cached_Vlist_len = 1;  
+  chr->cached_Elist_len = 0;
+  chr->cached_Nlist_len = 0;
+  chr->fitness = FITNESS_UNKNOWN;
+  chr->inside = -1;
+  chr->hash_V = zobrist_V(vertex);
 }
 
 /* Free the memory associated with this chromosome */
@@ -30,6 +44,8 @@ void chromosome_free(chromosome*  chr)
   ps_free(&chr->S);
   ps_free(&chr->V);
   free(chr->cached_Vlist);
+  free(chr->cached_Elist);
+  free(chr->cached_Nlist);
 }
 
 /* Copy a chromosome, destroying contents of chr */
@@ -39,23 +55,141 @@ void chromosome_copy(chromosome* chr, const chromosome* copy)
   ps_copy(&chr->S,&copy->S);
   ps_copy(&chr->V,&copy->V);
   
-  /* Update Vlist cache */
-  chromosome_update_cache(chr);
+  /* Copy the cached lists instead of rebuilding them */
+  memcpy(chr->cached_Vlist,copy->cached_Vlist,copy->cached_Vlist_len*sizeof(int));
+  chr->cached_Vlist_len = copy->cached_Vlist_len;
+  memcpy(chr->cached_Elist,copy->cached_Elist,copy->cached_Elist_len*sizeof(int));
+  chr->cached_Elist_len = copy->cached_Elist_len;
+  memcpy(chr->cached_Nlist,copy->cached_Nlist,copy->cached_Nlist_len*sizeof(int));
+  chr->cached_Nlist_len = copy->cached_Nlist_len;
+  chr->fitness = copy->fitness;
+  chr->inside = copy->inside;
+  chr->hash_S = copy->hash_S;
+  chr->hash_V = copy->hash_V;
 }
 
-/* Merge the vertex sets of chr1 and chr2 into dest, destroying contents of dest */
-void chromosome_vmerge(chromosome* dest, chromosome* chr1, chromosome* chr2)
+/* 
+ * Merge the vertex sets of chr1 and chr2 into dest, destroying
+ * contents of dest. The cached lists are built incrementally from
+ * those of chr1 by adding the vertices of chr2 that are not in chr1
+ * along with their incident edges inside the union.
+ */
+void chromosome_vmerge(chromosome* dest, const chromosome* chr1, const chromosome* chr2, const graph_data* G)
 {
+  int i, j;
+  assert(dest != chr1 && dest != chr2);
+
   /* Merge vertex sets */
   ps_union(&dest->V,&chr1->V,&chr2->V);
+  dest->fitness = FITNESS_UNKNOWN;
+  dest->inside = -1;
+
+  /* Start from the cached lists of chr1 */
+  memcpy(dest->cached_Vlist,chr1->cached_Vlist,chr1->cached_Vlist_len*sizeof(int));
+  dest->cached_Vlist_len = chr1->cached_Vlist_len;
+  memcpy(dest->cached_Elist,chr1->cached_Elist,chr1->cached_Elist_len*sizeof(int));
+  dest->cached_Elist_len = chr1->cached_Elist_len;
+  memcpy(dest->cached_Nlist,chr1->cached_Nlist,chr1->cached_Nlist_len*sizeof(int));
+  dest->cached_Nlist_len = chr1->cached_Nlist_len;
+  dest->hash_V = chr1->hash_V;
 
-  /* Update Vlist cache */
-  chromosome_update_cache(dest);
+  for (i=0; i<chr2->cached_Vlist_len; i++){
+    int v = chr2->cached_Vlist[i];
+    if (ps_read(&chr1->V,v)) continue;
+    dest->cached_Vlist[dest->cached_Vlist_len++] = v;
+    dest->hash_V ^= zobrist_V(v);
+    for (j=0; j<G->adj_list_len[v]; j++){
+      int u = G->adj_list[v][j];
+      /* edges into chr1 are only seen from this side, edges within
+	 chr2 \ chr1 are seen twice so keep the one from the smaller
+	 endpoint */
+      if (ps_read(&chr1->V,u) || (ps_read(&chr2->V,u) && v < u)){
+	dest->cached_Elist[dest->cached_Elist_len++] = G->adj_elist[v][j];
+      }
+    }
+    /* likewise for the indexed non-edges, if any */
+    for (j=0; G->q > 0 && j<G->nadj_list_len[v]; j++){
+      int u = G->nadj_list[v][j];
+      if (ps_read(&chr1->V,u) || (ps_read(&chr2->V,u) && v < u)){
+	dest->cached_Nlist[dest->cached_Nlist_len++] = G->m + G->nadj_elist[v][j];
+      }
+    }
+  }
+}
+
+/* Flip element i of chr->S */
+void chromosome_flip(chromosome* chr, int i)
+{
+  ps_flip(&chr->S,i);
+  chr->hash_S ^= zobrist_S(i);
+  chr->fitness = FITNESS_UNKNOWN;
+  chr->inside = -1;
+}
+
+/* Insert element i into chr->S */
+void chromosome_store(chromosome* chr, int i)
+{
+  if (!ps_read(&chr->S,i)){
+    ps_store(&chr->S,i);
+    chr->hash_S ^= zobrist_S(i);
+    chr->fitness = FITNESS_UNKNOWN;
+    chr->inside = -1;
+  }
+}
+
+/* Recompute the hash of chr->S after it was modified directly */
+void chromosome_rehash(chromosome* chr)
+{
+  size_t i;
+  chr->hash_S = 0;
+  for (i=0; i<chr->S.word_cnt; i++){
+    word x = chr->S.data[i];
+    while (x){
+      chr->hash_S ^= zobrist_S((i << NBYTES) + __builtin_ctzl(x));
+      x &= x - 1;
+    }
+  }
+}
+
+/* Zobrist hash of the pair (V,S) */
+uint64_t chromosome_hash(const chromosome* chr)
+{
+  return chr->hash_S ^ chr->hash_V;
+}
+
+/* Forget the cached fitness */
+void chromosome_invalidate(chromosome* chr)
+{
+  chr->fitness = FITNESS_UNKNOWN;
+  chr->inside = -1;
 }
 
-void chromosome_update_cache(chromosome* chr)
+/* Rebuild the cached vertex and edge lists from chr->V */
+void chromosome_update_cache(chromosome* chr, const graph_data* G)
 {
+  int i, j;
   ps_contents(chr->cached_Vlist,&chr->cached_Vlist_len,&chr->V);  
+  chr->fitness = FITNESS_UNKNOWN;
+  chr->inside = -1;
+  chr->cached_Elist_len = 0;
+  chr->cached_Nlist_len = 0;
+  chr->hash_V = 0;
+  for (i=0; i<chr->cached_Vlist_len; i++){
+    int v = chr->cached_Vlist[i];
+    chr->hash_V ^= zobrist_V(v);
+    for (j=0; j<G->adj_list_len[v]; j++){
+      int u = G->adj_list[v][j];
+      if (v < u && ps_read(&chr->V,u)){
+	chr->cached_Elist[chr->cached_Elist_len++] = G->adj_elist[v][j];
+      }
+    }
+    for (j=0; G->q > 0 && j<G->nadj_list_len[v]; j++){
+      int u = G->nadj_list[v][j];
+      if (v < u && ps_read(&chr->V,u)){
+	chr->cached_Nlist[chr->cached_Nlist_len++] = G->m + G->nadj_elist[v][j];
+      }
+    }
+  }
 }
 
 void chromosome_debug(chromosome* chr)
@@ -7,9 +7,34 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "packed_set.h"
+#include "graph.h"
 
+/* Fitness of a chromosome: |S| if feasible, otherwise one of these */
+#define FITNESS_INFEASIBLE  -1
+#define FITNESS_UNKNOWN     -2
+#define FITNESS_OVER_BUDGET -3
+
+/*
+ * cached_Vlist holds the vertices of V and cached_Elist the edges of
+ * the induced subgraph G[V] (in no particular order); cached_Nlist
+ * holds the indexed non-edges inside V as elements of S (m plus their
+ * index, see index_nonedges)
+ *
+ * fitness caches the result of the last evaluation; it is
+ * FITNESS_UNKNOWN whenever S or V have been modified since
+ *
+ * inside caches the number of elements of S that count against the
+ * budget (vertices of V for CVD, edges of G[V] for CD, edges and
+ * non-edges of G[V] for CEP); it is -1
+ * whenever it is not known
+ *
+ * hash_S and hash_V are Zobrist hashes of S and V, kept up to date by
+ * the functions below (code modifying S directly must call
+ * chromosome_rehash)
+ */
 typedef struct {
   packed_set S;
   packed_set V;
@@ -17,10 +42,16 @@ typedef struct {
   int  cached_Vlist_len;
   int* cached_Elist;
   int  cached_Elist_len;
+  int* cached_Nlist;
+  int  cached_Nlist_len;
+  int  fitness;
+  int  inside;
+  uint64_t hash_S;
+  uint64_t hash_V;
 } chromosome;
 
-/* Initialize chromosome chr with solution size len and vertex size n */
-void chromosome_init(chromosome* chr, size_t len, size_t n);
+/* Initialize chromosome chr with solution size len for the graph G */
+void chromosome_init(chromosome* chr, size_t len, const graph_data* G);
 
 /* "Seed" a chromosome chr by inserting a single vertex v into its graph */
 void chromosome_seed(chromosome* chr, int v);
@@ -32,10 +63,25 @@ void chromosome_free(chromosome* chr);
 void chromosome_copy(chromosome* dest, const chromosome* src);
 
 /* Merge the vertex sets of p1 and p2 into dest */
-void chromosome_vmerge(chromosome* dest, chromosome* p1, chromosome*p2);
+void chromosome_vmerge(chromosome* dest, const chromosome* p1, const chromosome* p2, const graph_data* G);
 
 /* Update the cached vertex/edge lists (this must be done any time chr->V is changed, which isn't often */
-void chromosome_update_cache(chromosome* chr);
+void chromosome_update_cache(chromosome* chr, const graph_data* G);
+
+/* Flip element i of chr->S */
+void chromosome_flip(chromosome* chr, int i);
+
+/* Insert element i into chr->S */
+void chromosome_store(chromosome* chr, int i);
+
+/* Recompute the hash of chr->S after it was modified directly */
+void chromosome_rehash(chromosome* chr);
+
+/* Zobrist hash of the pair (V,S) */
+uint64_t chromosome_hash(const chromosome* chr);
+
+/* Forget the cached fitness (this must be done any time chr->S or chr->V is changed) */
+void chromosome_invalidate(chromosome* chr);
 
 void chromosome_debug(chromosome*);
 
@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "packed_set.h"
+#include "graph.h"
+#include "cvd.h"
+#include "cd.h"
+#include "cep.h"
+#include "fpt.h"
+#include "parallel.h"
+#include "context.h"
+
+/*
+ * Random words buffered per word of a solution set: crossover takes
+ * two per word and redraws the pairs that came up 11, which takes
+ * about four rounds in all
+ */
+#define RBITS_PER_WORD 8
+
+/* Create a context for solving the given problem type on G with budget k */
+context* context_create(const graph_data* G, prob_type type, int k)
+{
+  /* zeroed, since pcg64_getentropy only seeds part of the generator */
+  context* ctx = calloc(1,sizeof(context));
+  ctx->G = G;
+  ctx->k = k;
+  ctx->type = type;
+  if (type == CVD) ctx->setlen = G->n;
+  if (type == CD) ctx->setlen = G->m;
+  if (type == CEP) ctx->setlen = G->m + G->q;
+  pcg64_getentropy(&ctx->rng);
+  pcg64_streams_seed(&ctx->streams,&ctx->rng);
+  ctx->rbits_len = RBITS_PER_WORD*((ctx->setlen >> NBYTES) + 1);
+  ctx->rbits = malloc(ctx->rbits_len*sizeof(uint64_t));
+  ctx->rbits_pos = ctx->rbits_len;
+  ctx->cvd = (type == CVD) ? cvd_workspace_create(G) : NULL;
+  ctx->cd = (type == CD) ? cd_workspace_create(G) : NULL;
+  ctx->cep = (type == CEP) ? cep_workspace_create(G) : NULL;
+  ctx->fpt = (type == CVD || type == CD) ? fpt_workspace_create(G,type) : NULL;
+  return ctx;
+}
+
+/*
+ * Replace the generator by the stream-th one split off it, so that
+ * contexts created from the same seed can draw independently
+ */
+void context_stream(context* ctx, int stream)
+{
+  pcg64_random_t seed = ctx->rng;
+  int i;
+  for (i=0; i<stream; i++) pcg64_random_split(&ctx->rng,&seed);
+  pcg64_streams_seed(&ctx->streams,&ctx->rng);
+  ctx->rbits_pos = ctx->rbits_len;
+}
+
+/* Seed the generators from a generator split off seed */
+void context_seed(context* ctx, pcg64_random_t* seed)
+{
+  pcg64_random_split(&ctx->rng,seed);
+  pcg64_streams_seed(&ctx->streams,&ctx->rng);
+  ctx->rbits_pos = ctx->rbits_len;
+}
+
+/* Split the feasibility tests of large chromosomes across threads */
+void context_parallel(context* ctx, int threads)
+{
+  if (ctx->pool) par_destroy(ctx->pool);
+  ctx->pool = (threads > 1) ? par_create(threads) : NULL;
+}
+
+/* Free a context (but not its graph) */
+void context_destroy(context* ctx)
+{
+  if (ctx->cvd) cvd_workspace_destroy(ctx->cvd);
+  if (ctx->cd) cd_workspace_destroy(ctx->cd);
+  if (ctx->cep) cep_workspace_destroy(ctx->cep);
+  if (ctx->fpt) fpt_workspace_destroy(ctx->fpt);
+  if (ctx->pool) par_destroy(ctx->pool);
+  free(ctx->rbits);
+  free(ctx);
+}
@@ -0,0 +1,73 @@
+/*
+ * Operator context: the graph, budget, random number streams and
+ * scratch space used by the genetic operators. Operators share no
+ * other state, so operators working on different contexts can run
+ * concurrently, on the same graph or on different ones.
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "pcg64_rng.h"
+#include "graph.h"
+#include "params.h"
+#include "parallel.h"
+
+struct cvd_workspace;
+struct cd_workspace;
+struct cep_workspace;
+struct fpt_workspace;
+
+/*
+ * G is the graph (shared, never modified), k the budget, and setlen
+ * the capacity of the solution sets (n for CVD, m for CD, m+q for CEP)
+ *
+ * rbits[rbits_pos..rbits_len-1] are the random words not yet used by
+ * crossover, drawn in bulk from streams and refilled when used up;
+ * cvd/cd/cep the scratch space of the problem's operators (NULL for
+ * the other problem types), and fpt that of the exact solver (CVD and
+ * CD only). All of it is allocated by context_create, so that the
+ * operators never allocate.
+ *
+ * pool, if not NULL, holds the threads the feasibility tests of large
+ * chromosomes are split across
+ */
+typedef struct context {
+  const graph_data* G;
+  int k;
+  prob_type type;
+  size_t setlen;
+  pcg64_random_t rng;
+  pcg64_streams_t streams;
+  uint64_t* rbits;
+  size_t rbits_len;
+  size_t rbits_pos;
+  struct cvd_workspace* cvd;
+  struct cd_workspace* cd;
+  struct cep_workspace* cep;
+  struct fpt_workspace* fpt;
+  par_pool* pool;
+} context;
+
+/* Create a context for solving the given problem type on G with budget k */
+context* context_create(const graph_data* G, prob_type type, int k);
+
+/*
+ * Replace the generator by the stream-th one split off it, so that
+ * contexts created from the same seed can draw independently
+ */
+void context_stream(context* ctx, int stream);
+
+/* Seed the generators from a generator split off seed */
+void context_seed(context* ctx, pcg64_random_t* seed);
+
+/* Split the feasibility tests of large chromosomes across threads */
+void context_parallel(context* ctx, int threads);
+
+/* Free a context (but not its graph) */
+void context_destroy(context* ctx);
+
+#endif
@@ -3,24 +3,122 @@
 #include <string.h>
 #include <assert.h>
 
-/* Uses GNU Linear Programming Kit */
-#include <glpk.h> 
-
 #include "chromosome.h"
 #include "packed_set.h"
 #include "graph.h"
+#include "assign.h"
+#include "witness.h"
+#include "context.h"
+#include "parallel.h"
 #include "cvd.h"
 
+/* Scratch space of the CVD operators: repair cluster maps and witnesses */
+struct cvd_workspace {
+  /* V \ S for cvd_feasible */
+  packed_set tmp;
+
+  /* A is the set of vertices that cannot be deleted */
+  packed_set A;
+
+  /* Map V -> A-cluster number (0 for vertices not in A) */
+  int* AClusterMap;
+
+  /* Asize[c] is the number of vertices in A-cluster c */
+  int* Asize;
+
+  /* Map V \ A -> C-class number (DELETED for vertices in D) */
+  int* CClassMap;
+
+  /* Map V \ A -> B-cluster number (0 for vertices not yet clustered) */
+  int* BClusterMap;
+
+  /* Blist[Bstart[c]...Bstart[c+1]-1] are the vertices of B-cluster c */
+  int* Blist;
+  int* Bstart;
+
+  /* Ccount[j] counts the vertices of one B-cluster in C-class j */
+  int* Ccount;
+
+  /* Dlist is the list of vertices to delete (D) */
+  int* Dlist;
+
+  /* Workspace of the assignment solver */
+  assign_ws assignment;
+
+  /* Recently found P3s (v,u,w) of v-u-w */
+  witness_cache witnesses;
+
+  /* P3 found by each thread of a scan */
+  int found[PAR_MAX_THREADS][3];
+};
+
+/* Arguments of a scan for P3s inside G[V & A] */
+struct cvd_scan {
+  const chromosome* offspr;
+  const packed_set* A;
+  context* ctx;
+};
+
+/* Allocate the scratch space of the CVD operators for the graph G */
+struct cvd_workspace* cvd_workspace_create(const graph_data* G)
+{
+  struct cvd_workspace* ws = malloc(sizeof(struct cvd_workspace));
+  ps_init(&ws->tmp,G->n);
+  ps_init(&ws->A,G->n);
+  ws->AClusterMap = calloc(G->n,sizeof(int));
+  ws->Asize = malloc(sizeof(int)*(G->n+1));
+  ws->CClassMap = malloc(sizeof(int)*G->n);
+  ws->BClusterMap = calloc(G->n,sizeof(int));
+  ws->Blist = malloc(sizeof(int)*G->n);
+  ws->Bstart = malloc(sizeof(int)*(G->n+2));
+  ws->Ccount = calloc(G->n+1,sizeof(int));
+  ws->Dlist = malloc(sizeof(int)*G->n);
+  assign_init(&ws->assignment,G->n,G->n,G->n);
+  wc_clear(&ws->witnesses);
+  return ws;
+}
+
+/* Free the scratch space of the CVD operators */
+void cvd_workspace_destroy(struct cvd_workspace* ws)
+{
+  ps_free(&ws->tmp);
+  ps_free(&ws->A);
+  free(ws->AClusterMap);
+  free(ws->Asize);
+  free(ws->CClassMap);
+  free(ws->BClusterMap);
+  free(ws->Blist);
+  free(ws->Bstart);
+  free(ws->Ccount);
+  free(ws->Dlist);
+  assign_free(&ws->assignment);
+  free(ws);
+}
+
+/* Statistics of the P3 witness cache */
+const witness_cache* cvd_witnesses(const context* ctx)
+{
+  return &ctx->cvd->witnesses;
+}
+
 /* 
- * Determine if G[offspr->V & A] is a cluster graph
+ * Scan the vertices first, first+step, ... of V & A for a P3 inside
+ * G[V & A], recording it in ws->found[first]
  */
-bool cvd_cluster_graph(const chromosome* offspr, const packed_set* A, const graph_data* G)
+static bool cvd_scan_p3s(int first, int step, void* arg, const atomic_bool* stop)
 {
+  const struct cvd_scan* sc = arg;
+  const chromosome* offspr = sc->offspr;
+  const packed_set* A = sc->A;
+  const graph_data* G = sc->ctx->G;
+  struct cvd_workspace* ws = sc->ctx->cvd;
   int i, j;
-  for (i=0; i<offspr->cached_Vlist_len; i++){
+
+  for (i=first; i<offspr->cached_Vlist_len; i+=step){
     /* for each v in V*/
     if (ps_read(A,offspr->cached_Vlist[i])){ /* if v is in A */
       int v = offspr->cached_Vlist[i];
+      if (atomic_load_explicit(stop,memory_order_relaxed)) return false;
       /* check all p3s of v if they are also in V & A */
       for (j=0; j<G->p3_vlist_len[v]; j++){
 	int u = src(G->p3_vlist[v][j]);
@@ -28,89 +126,156 @@ bool cvd_cluster_graph(const chromosome* offspr, const packed_set* A, const grap
 	//int u = G->p3_vlist[v][2*j];
 	//int w = G->p3_vlist[v][2*j+1];
 	if (ps_read(A,u) && ps_read(&offspr->V,u) && ps_read(A,w) && ps_read(&offspr->V,w)) {
-	  return false;
+	  ws->found[first][0] = v;
+	  ws->found[first][1] = u;
+	  ws->found[first][2] = w;
+	  return true;
 	}
       }
     }
   }
+  return false;
+}
+
+/* 
+ * Determine if G[offspr->V & A] is a cluster graph (scanning in
+ * parallel if the context has threads and V is large)
+ */
+bool cvd_cluster_graph(const chromosome* offspr, const packed_set* A, context* ctx)
+{
+  struct cvd_workspace* ws = ctx->cvd;
+  struct cvd_scan sc = { offspr, A, ctx };
+  atomic_bool never = false;
+  int i, t;
+
+  /* try the P3s that were found recently first */
+  ws->witnesses.lookups++;
+  for (i=0; i<ws->witnesses.len; i++){
+    int v = ws->witnesses.x[i];
+    int u = ws->witnesses.y[i];
+    int w = ws->witnesses.z[i];
+    if (ps_read(A,v) && ps_read(&offspr->V,v) && ps_read(A,u) && ps_read(&offspr->V,u) && ps_read(A,w) && ps_read(&offspr->V,w)) {
+      ws->witnesses.rejections++;
+      ws->witnesses.hits++;
+      return false;
+    }
+  }
+
+  if (ctx->pool && offspr->cached_Vlist_len >= PAR_MIN_VERTICES) t = par_any(ctx->pool,cvd_scan_p3s,&sc);
+  else t = cvd_scan_p3s(0,1,&sc,&never) ? 0 : -1;
+  if (t >= 0){
+    ws->witnesses.rejections++;
+    wc_store(&ws->witnesses,ws->found[t][0],ws->found[t][1],ws->found[t][2]);
+    return false;
+  }
   /* no P3s found */
   return true;
 }
 
 /* Determine if G[V \ S] is a cluster graph */
-bool cvd_feasible(const chromosome* offspr, const graph_data* G)
+bool cvd_feasible(const chromosome* offspr, context* ctx)
 {
-  /* TODO: probably can improve memory management here... */
-  packed_set tmp;
-  bool is_cluster_graph;
-  if (ps_popcount_and(&offspr->S,&offspr->V) > (size_t)G->k) return false;
-  ps_copyinit(&tmp,&offspr->V);
-  ps_subtract(&tmp,&offspr->S);
-  is_cluster_graph = cvd_cluster_graph(offspr,&tmp,G);  
-  ps_free(&tmp);
-  return is_cluster_graph;
+  struct cvd_workspace* ws = ctx->cvd;
+  if (ps_popcount_and(&offspr->S,&offspr->V) > (size_t)ctx->k) return false;
+  ps_copy(&ws->tmp,&offspr->V);
+  ps_subtract(&ws->tmp,&offspr->S);
+  return cvd_cluster_graph(offspr,&ws->tmp,ctx);  
 }
 
-bool cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, const graph_data* G)
-{
-  int i,j,c,m,l;
-
-  /* LP problem structure */
-  glp_prob *lp;
+/* C-class of the vertices that must be deleted */
+#define DELETED -1
 
-  /* Parameters for simplex solver */
-  glp_smcp solver_params;
+/* 
+ * Fitness of a mutant of a feasible parent: chr is the parent, of
+ * fitness rp and with ip vertices of V in S (-1 if unknown), after
+ * flipping the elements in flips. Only vertices leaving S can create
+ * a P3, so only the P3s through them are checked. Caches the fitness
+ * and budget count of chr.
+ */
+int cvd_mutant_fitness(chromosome* chr, int rp, int ip, const int* flips, size_t nflips, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  size_t i;
+  int j, inside = ip;
+
+  chr->fitness = rp;
+  for (i=0; i<nflips; i++){
+    if (ps_read(&chr->S,flips[i])){
+      chr->fitness++;
+      if (ip >= 0 && ps_read(&chr->V,flips[i])) inside++;
+    }
+    else {
+      chr->fitness--;
+      if (ip >= 0 && ps_read(&chr->V,flips[i])) inside--;
+    }
+  }
+  if (ip < 0) inside = ps_popcount_and(&chr->S,&chr->V);
+  if (inside > ctx->k) {
+    chr->fitness = FITNESS_INFEASIBLE;
+    return chr->fitness;
+  }
 
-  /* A is the set of vertices that cannot be deleted */
-  static packed_set A;
-  
-  /* D is the set of vertices to delete */
-  static packed_set D;
-
-  /* A set structure for storing vertices */
-  static packed_set vertex_store;
-
-  /* Map V -> cluster number*/
-  static int* AClusterMap;
-
-  /* Apartition[i] is the set of A vertices in A-cluster i */
-  static packed_set* Apartition;
-
-  /* Bpartition[i] is the set of B = V \ A vertices in B-cluster i */
-  static packed_set* Bpartition;
-
-  /* Cpartition[i] is the set of B = V \ A vertices in C-partition i */
-  static packed_set* Cpartition;
-
-  /* Initialization flag */
-  static bool initialized = false;
-
-  /* Initialize static data structures the first time repair is called */
-  if (!initialized){
-    ps_init(&A,G->n);
-    ps_init(&D,G->n);
-    ps_init(&vertex_store,G->n);
-    AClusterMap = malloc(sizeof(int)*G->n);
-    Apartition = malloc(sizeof(packed_set)*G->n);
-    Bpartition = malloc(sizeof(packed_set)*G->n);
-    Cpartition = malloc(sizeof(packed_set)*G->n);
-    for (i=0; i<G->n; i++){
-      ps_init(&Apartition[i],G->n);
-      ps_init(&Bpartition[i],G->n);
-      ps_init(&Cpartition[i],G->n);
+  for (i=0; i<nflips; i++){
+    int v = flips[i];
+    if (ps_read(&chr->S,v) || !ps_read(&chr->V,v)) continue;
+    /* P3s with v as an endpoint */
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int u = src(G->p3_vlist[v][j]);
+      int w = snk(G->p3_vlist[v][j]);
+      if (ps_read(&chr->V,u) && !ps_read(&chr->S,u) && ps_read(&chr->V,w) && !ps_read(&chr->S,w)) {
+	chr->fitness = FITNESS_INFEASIBLE;
+	return chr->fitness;
+      }
+    }
+    /* P3s with v in the middle */
+    for (j=0; j<G->p3_mlist_len[v]; j++){
+      int u = src(G->p3_mlist[v][j]);
+      int w = snk(G->p3_mlist[v][j]);
+      if (ps_read(&chr->V,u) && !ps_read(&chr->S,u) && ps_read(&chr->V,w) && !ps_read(&chr->S,w)) {
+	chr->fitness = FITNESS_INFEASIBLE;
+	return chr->fitness;
+      }
     }
-    initialized = true;
   }
+  chr->inside = inside;
+  return chr->fitness;
+}
+
+/* 
+ * Repair operator for CVD
+ *
+ * All scratch structures are indexed by vertex and reset only at the
+ * vertices of V, so the cost of a call depends on the size and degree
+ * of G[V] rather than on n.
+ *
+ * Returns the fitness of the repaired offspring if it is already
+ * known (and caches it in offspr), FITNESS_OVER_BUDGET (leaving
+ * offspr unrepaired) as soon as the repaired offspring would have
+ * more than k vertices of V in S, otherwise FITNESS_UNKNOWN
+ */
+int cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct cvd_workspace* ws = ctx->cvd;
+  int i,j,c,m,l,len,inside,added;
 
-  /* Determine set A = (x | y | template) - self.S */
-  ps_zero(&A);
-  ps_union(&A,x,y);
-  ps_union(&A,&A,t);
-  ps_subtract(&A,&offspr->S);
-  ps_intersect(&A,&A,&offspr->V); /* keep only vertices in V */
+  /* Determine set A = ((x | y | template) - self.S) & V, and how
+     much of the budget S & V already uses */
+  inside = 0;
+  for (i=0; i<offspr->cached_Vlist_len; i++){
+    int v = offspr->cached_Vlist[i];
+    if (ps_read(&offspr->S,v)) inside++;
+    else if (ps_read(x,v) || ps_read(y,v) || ps_read(t,v)) ps_store(&ws->A,v);
+  }
 
-  /* If G[A] is not a cluster graph, then fail */
-  if (!cvd_cluster_graph(offspr,&A,G)) return false;
+  /* If G[A] is not a cluster graph, then fail: G[A] is an induced
+     subgraph of G[V \ S], so offspr cannot be feasible */
+  if (inside > ctx->k || !cvd_cluster_graph(offspr,&ws->A,ctx)) {
+    for (i=0; i<offspr->cached_Vlist_len; i++) ps_clear(&ws->A,offspr->cached_Vlist[i]);
+    if (inside > ctx->k) return FITNESS_OVER_BUDGET;
+    offspr->fitness = FITNESS_INFEASIBLE;
+    return offspr->fitness;
+  }
 
 
   /* ********************** */
@@ -118,37 +283,26 @@ bool cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, co
   /* ********************** */
   
   /* Cluster 0 is reserved for "not in A" */
-  memset(AClusterMap,0,sizeof(int)*G->n);
   for (i=0,c=1; i<offspr->cached_Vlist_len; i++){
     int v = offspr->cached_Vlist[i];
-    if (ps_read(&A,v) && AClusterMap[v] == 0){
-      AClusterMap[v] = c;
+    if (ps_read(&ws->A,v) && ws->AClusterMap[v] == 0){
+      ws->AClusterMap[v] = c;
+      ws->Asize[c] = 0;
       for (j=0; j<G->adj_list_len[v]; j++){
 	int u = G->adj_list[v][j];
-	if (ps_read(&A,u)) {
+	if (ps_read(&ws->A,u)) {
 	  /* XXX BUG: this seems to intermittently fail */
-	  assert(AClusterMap[u] == 0 || AClusterMap[u] == c);
-	  AClusterMap[u] = c;
+	  assert(ws->AClusterMap[u] == 0 || ws->AClusterMap[u] == c);
+	  ws->AClusterMap[u] = c;
 	}
       }
       c++;
     }
   }
   l = c-1;
-
-
-  /* Zero out structures */
-  for (i=0; i<G->n; i++){
-    ps_zero(&Apartition[i]);
-    ps_zero(&Bpartition[i]);
-    ps_zero(&Cpartition[i]);
-  }
-  ps_zero(&D);
-  
-  /* Compute the A partitions */
   for (i=0; i<offspr->cached_Vlist_len; i++){
     int v = offspr->cached_Vlist[i];
-    if (ps_read(&A,v)) ps_store(&Apartition[AClusterMap[v]],v);
+    if (ws->AClusterMap[v]) ws->Asize[ws->AClusterMap[v]]++;
   }
 
   /* ******************************* */
@@ -156,62 +310,51 @@ bool cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, co
   /* ******************************* */
   
   /* For each u in V \ A */
+  len = added = 0;
   for (i=0; i<offspr->cached_Vlist_len; i++){
     int u = offspr->cached_Vlist[i];        
-    if (!ps_read(&A,u)){
-      int adjacentClusters =0;
-      int c=-1;
+    if (!ps_read(&ws->A,u)){
+      int adjacent = 0;
+      bool straddles = false;
+      c = 0;
       
-      /* Store the neighbors of u that are in V */
-      ps_zero(&vertex_store);
+      /* See which clusters of A u is adjacent to, and to how many
+	 vertices of the first one */
       for (j=0; j<G->adj_list_len[u]; j++){
 	int w = G->adj_list[u][j];
-	if (ps_read(&offspr->V,w)){
-	  ps_store(&vertex_store,w);
+	if (ws->AClusterMap[w]){
+	  if (c == 0) c = ws->AClusterMap[w];
+	  if (ws->AClusterMap[w] == c) adjacent++;
+	  else straddles = true;
 	}
       }
-      /* See how many clusters of A u is adjacent to */
-      for (j=1; j<=l; j++){
-	if (ps_popcount_and(&vertex_store,&Apartition[j])){
-	  adjacentClusters++;
-	  c=j;
-	}
-      }
-      if (adjacentClusters == 0){
+      if (c == 0){
 	/* u is not adjacent to any clusters of A, store in C0 */
-	ps_store(&Cpartition[0],u);
+	ws->CClassMap[u] = 0;
       }
-      else if (adjacentClusters == 1){
-	assert(c > 0);	
-	/* check if Apartition[c] is a subset of stored neighbors of u */
-	if (ps_compare(&Apartition[c],&vertex_store) >= 0){
-	  /* if so, store u into Cpartition[c] */
-	  ps_store(&Cpartition[c],u);
-	}
-	else {
-	  /* u is not adjacent to all members of the cluster: delete */
-	  ps_store(&D,u);
-	}
+      else if (!straddles && adjacent == ws->Asize[c]){
+	/* u is adjacent to all of A-cluster c, store in Cc */
+	ws->CClassMap[u] = c;
       }
       else {
-	/* u straddles more than one cluster: delete */
-	ps_store(&D,u);
+	/* u straddles more than one cluster or is not adjacent to
+	   all members of the cluster: delete */
+	ws->CClassMap[u] = DELETED;
+	ws->Dlist[len++] = u;
+	if (!ps_read(&offspr->S,u)) added++;
       }
     }
   }
                         
   /* Now find the clusters of B */
-  ps_zero(&vertex_store);	  
   for (i=0,c=1; i<offspr->cached_Vlist_len; i++){
     int v = offspr->cached_Vlist[i];
-    if (!ps_read(&A,v) && !ps_read(&D,v) && !ps_read(&vertex_store,v)){
-      ps_store(&Bpartition[c],v);
-      ps_store(&vertex_store,v);
+    if (!ps_read(&ws->A,v) && ws->CClassMap[v] != DELETED && ws->BClusterMap[v] == 0){
+      ws->BClusterMap[v] = c;
       for (j=0; j<G->adj_list_len[v]; j++){
 	int u = G->adj_list[v][j];
-	if (!ps_read(&A,u) && !ps_read(&D,u)  && !ps_read(&vertex_store,u) && ps_read(&offspr->V,u)) {
-	  ps_store(&Bpartition[c],u);
-	  ps_store(&vertex_store,u);
+	if (ps_read(&offspr->V,u) && !ps_read(&ws->A,u) && ws->CClassMap[u] != DELETED && ws->BClusterMap[u] == 0) {
+	  ws->BClusterMap[u] = c;
 	}
       }
       c++;
@@ -219,115 +362,91 @@ bool cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, co
   }
   m = c-1;
 
-  /* ******************************** */
-  /* If l,m > 0 solve the LP instance */
-  /* ******************************** */
-  if (l*m > 0){
-    packed_set tmp;
-    int* row_idx, *col_idx;
-    double* constr_mat;
-    int el;
-    
-    ps_init(&tmp,G->n);
-    for (i=1; i<=m; i++){
-      for (j=0; j<l+1; j++){
-	ps_copy(&tmp,&Bpartition[i]);
-	ps_subtract(&tmp,&Cpartition[j]);
-      }
-    }
+  /* ************************************************ */
+  /* If l,m > 0 solve the assignment of B-clusters to */
+  /* C-classes (at most one cluster per class j > 0)  */
+  /* ************************************************ */
+
+  /* (skipped if the forced deletions alone exceed the budget) */
+  if (inside + added <= ctx->k && l*m > 0){
+    long cost;
 
-    /* ************************** */
-    /* Create LP problem instance */
-    /* ************************** */
-    glp_init_smcp(&solver_params);
-    solver_params.msg_lev = GLP_MSG_ERR;
-    solver_params.meth = GLP_PRIMAL;
-    /* solver_params.it_lim: iteration limit (default INT_MAX) */
-    /* solver_params.tm_lim: time limit (ms) (default INT_MAX) */
-    /* solver_params.presolve:  LP presolver (default GLP_OFF) */
-
-    lp = glp_create_prob();
-    glp_set_obj_dir(lp,GLP_MIN);
-    glp_add_cols(lp,m*(l+1));
-    glp_add_rows(lp,m+(l+1)); 
-
-    /* there are exactly 2lm+m nonzero entries in constraint matrix */
-    row_idx = calloc(1+2*l*m+m,sizeof(int));
-    col_idx = calloc(1+2*l*m+m,sizeof(int));
-    constr_mat = calloc(1+2*l*m+m,sizeof(double));
-
-
-    /* ***************************** */
-    /* Compute the constraint matrix */
-    /* ***************************** */    
-    el=1;
-    /* First m constraints: each cluster Bi is assigned exactly one class */
+    /* Group the vertices of B by cluster (counting sort) */
+    for (c=1; c<=m+1; c++) ws->Bstart[c] = 0;
+    for (i=0; i<offspr->cached_Vlist_len; i++){
+      int v = offspr->cached_Vlist[i];
+      if (ws->BClusterMap[v]) ws->Bstart[ws->BClusterMap[v]+1]++;
+    }
+    for (c=2; c<=m+1; c++) ws->Bstart[c] += ws->Bstart[c-1];
+    for (i=0; i<offspr->cached_Vlist_len; i++){
+      int v = offspr->cached_Vlist[i];
+      if (ws->BClusterMap[v]) ws->Blist[ws->Bstart[ws->BClusterMap[v]]++] = v;
+    }
+    for (c=m+1; c>1; c--) ws->Bstart[c] = ws->Bstart[c-1];
+    ws->Bstart[1] = 0;
+
+    /* 
+     * Assigning B-cluster i to class j costs |Bi \ Cj|; class 0 is
+     * every cluster's default, and class j > 0 is only worth offering
+     * if it is cheaper than that
+     */
+    assign_reset(&ws->assignment,m,l);
     for (i=1; i<=m; i++){
-      for (j=0; j<=l; j++){      
-	int idx = (i-1)*(l+1) + (j+1);
-	ps_copy(&tmp,&Bpartition[i]);
-	ps_subtract(&tmp,&Cpartition[j]);
-	glp_set_obj_coef(lp,idx,(double)ps_popcount(&tmp));	
-	glp_set_col_bnds(lp,idx,GLP_DB,0.0,1.0);
-	row_idx[el] = i;
-	col_idx[el] = idx;
-	constr_mat[el] = 1.0;
-	el++;
+      int size = ws->Bstart[i+1] - ws->Bstart[i];
+      int dflt;
+      for (j=ws->Bstart[i]; j<ws->Bstart[i+1]; j++) ws->Ccount[ws->CClassMap[ws->Blist[j]]]++;
+      dflt = size - ws->Ccount[0];
+      assign_default(&ws->assignment,i-1,dflt);
+      for (j=ws->Bstart[i]; j<ws->Bstart[i+1]; j++){
+	int cls = ws->CClassMap[ws->Blist[j]];
+	if (cls > 0 && ws->Ccount[cls] > 0 && size - ws->Ccount[cls] < dflt){
+	  assign_add(&ws->assignment,i-1,cls-1,size - ws->Ccount[cls]);
+	}
+	ws->Ccount[cls] = 0;
       }
-      glp_set_row_bnds(lp,i,GLP_FX,1.0,1.0);
     }
-    /* Next l constraints: class Cj (j > 0) has at most one cluster assigned to it */
-    for (j=1; j<=l; j++){
-      for (i=1; i<=m; i++){
-	int idx = (i-1)*(l+1) + (j+1);
-	row_idx[el] = m+j;
-	col_idx[el] = idx;
-	constr_mat[el] = 1.0;
-	el++;
+    cost = assign_solve(&ws->assignment);
+#ifdef USE_GLPK
+    assert(cost == assign_lp_cost(&ws->assignment));
+#else
+    (void)cost;
+#endif
+
+    /* Delete the vertices of each cluster outside its class */
+    for (i=1; i<=m; i++){
+      int cls = assign_column(&ws->assignment,i-1) + 1;
+      for (j=ws->Bstart[i]; j<ws->Bstart[i+1]; j++){
+	if (ws->CClassMap[ws->Blist[j]] != cls) {
+	  if (!ps_read(&offspr->S,ws->Blist[j])) added++;
+	  ws->Dlist[len++] = ws->Blist[j];
+	}
       }
-      glp_set_row_bnds(lp,m+j,GLP_UP,0,1.0);
     }
-    glp_load_matrix(lp,el-1,&row_idx[0],&col_idx[0],&constr_mat[0]);
+  }
 
-    /* ************ */
-    /* Solve the LP */
-    /* ************ */    
-    glp_simplex(lp,&solver_params);
+  /* S = S | D, unless that exceeds the budget */
+  if (inside + added <= ctx->k) {
+    for (i=0; i<len; i++) chromosome_store(offspr,ws->Dlist[i]);
+    chromosome_invalidate(offspr);
+  }
 
-    /* ******************************************* */
-    /* Retrieve the variables and translate to set */
-    /* ******************************************* */
-    for (i=1; i<=m; i++){
-      for (j=0; j<=l; j++){
-	//fprintf(stderr,"x%d%d=%f\n",i,j,glp_get_col_prim(lp,(i-1)*(l+1) + (j+1)));
-	if (glp_get_col_prim(lp,(i-1)*(l+1) + (j+1)) > 0.99){
-	  ps_copy(&tmp,&Bpartition[i]);
-	  ps_subtract(&tmp,&Cpartition[j]);
-	  ps_union(&D,&D,&tmp);
-	}
-      }
-    }   
-    ps_union(&offspr->S,&offspr->S,&D);
-
-
-    /* ************************* */
-    /* Clean up after the solver */
-    /* ************************* */
-    ps_free(&tmp);
-    glp_delete_prob(lp);
-    free(row_idx);
-    free(col_idx);
-    free(constr_mat);
+  /* Reset the scratch structures at the vertices of V */
+  for (i=0; i<offspr->cached_Vlist_len; i++){
+    int v = offspr->cached_Vlist[i];
+    ps_clear(&ws->A,v);
+    ws->AClusterMap[v] = 0;
+    ws->BClusterMap[v] = 0;
   }
     
-  return true;
+  return (inside + added > ctx->k) ? FITNESS_OVER_BUDGET : FITNESS_UNKNOWN;
 }
 
 /*
  * Create a template parent z for CVD
  */
-void cvd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, const graph_data* G)
+void cvd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx)
 {
+  const graph_data* G = ctx->G;
   int i,j;
   assert(p1->S.capacity == p2->S.capacity && p1->S.capacity == z->capacity);
   ps_zero(z);
@@ -353,3 +472,37 @@ void cvd_template(packed_set* z, const chromosome* offspr, const chromosome* p1,
     }
   }
 }
+
+/*
+ * Greedy CVD solution H on all of G: delete the vertex in the most
+ * P3s of the remaining graph until there are none left
+ */
+void cvd_greedy(packed_set* H, const graph_data* G)
+{
+  int* count = malloc(G->n*sizeof(int));
+  int i, j, v;
+
+  ps_zero(H);
+  /* each P3 is listed at both its endpoints and at its middle */
+  for (v=0; v<G->n; v++) count[v] = G->p3_vlist_len[v] + G->p3_mlist_len[v];
+  for (;;){
+    for (i=0,v=-1; i<G->n; i++){
+      if (!ps_read(H,i) && count[i] > 0 && (v < 0 || count[i] > count[v])) v = i;
+    }
+    if (v < 0) break;
+
+    /* delete v, taking its P3s away from the other two vertices */
+    ps_store(H,v);
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int u = src(G->p3_vlist[v][j]);
+      int w = snk(G->p3_vlist[v][j]);
+      if (!ps_read(H,u) && !ps_read(H,w)) { count[u]--; count[w]--; }
+    }
+    for (j=0; j<G->p3_mlist_len[v]; j++){
+      int u = src(G->p3_mlist[v][j]);
+      int w = snk(G->p3_mlist[v][j]);
+      if (!ps_read(H,u) && !ps_read(H,w)) { count[u]--; count[w]--; }
+    }
+  }
+  free(count);
+}
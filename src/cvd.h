@@ -5,10 +5,17 @@
 #include "chromosome.h"
 #include "packed_set.h"
 #include "graph.h"
+#include "witness.h"
+#include "context.h"
 
-bool cvd_feasible(const chromosome* offspr, const graph_data* G);
-bool cvd_cluster_graph(const chromosome* offspr, const packed_set* A, const graph_data* G);
-bool cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, const graph_data* G);
-void cvd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, const graph_data* G);
+struct cvd_workspace* cvd_workspace_create(const graph_data* G);
+void cvd_workspace_destroy(struct cvd_workspace* ws);
+const witness_cache* cvd_witnesses(const context* ctx);
+bool cvd_feasible(const chromosome* offspr, context* ctx);
+bool cvd_cluster_graph(const chromosome* offspr, const packed_set* A, context* ctx);
+int cvd_mutant_fitness(chromosome* chr, int rp, int ip, const int* flips, size_t nflips, context* ctx);
+int cvd_repair(chromosome* offspr, const packed_set* x, const packed_set* y, const packed_set* t, context* ctx);
+void cvd_template(packed_set* z, const chromosome* offspr, const chromosome* p1, const chromosome* p2, context* ctx);
+void cvd_greedy(packed_set* H, const graph_data* G);
 
 #endif
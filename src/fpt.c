@@ -0,0 +1,289 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "chromosome.h"
+#include "packed_set.h"
+#include "graph.h"
+#include "ttable.h"
+#include "context.h"
+#include "fpt.h"
+
+/* State of an element (vertex for CVD, edge for CD) of G[V] */
+#define FREE      0
+#define DELETED   1
+#define PERMANENT 2
+
+/* Outcome of a scan of the conflicts (P3s) left in the graph */
+#define SCAN_CLUSTER 0	/* none left */
+#define SCAN_FAIL    1	/* they cannot be resolved within the budget */
+#define SCAN_FORCED  2	/* one had a single free element, now deleted */
+#define SCAN_BRANCH  3	/* branch on the free elements in ws->branch */
+
+/* Zobrist key of element i in state s (kept apart from zobrist_V) */
+#define fpt_key(I,S) zobrist_key((((uint64_t)(I) << 2) | (S)) + ((uint64_t)1 << 40))
+
+/* Search state of the exact solver: element states, trail and failure memo */
+struct fpt_workspace {
+  prob_type type;
+
+  /* Current state of each element, FREE outside the search */
+  char* state;
+
+  /* Elements that are not FREE, in the order they were set */
+  int* trail;
+  int trail_len;
+
+  /* Hash of the states, for looking up failed subproblems */
+  uint64_t hash;
+
+  /* Largest budget known to be too small for a subproblem */
+  ttable memo;
+
+  /* Elements of the conflicts packed by the current scan are stamped */
+  uint64_t* mark;
+  uint64_t stamp;
+
+  /* Free elements of the conflict to branch on */
+  int branch[3];
+  int branch_len;
+
+  /* Nodes visited by the current call, and whether it gave up */
+  size_t nodes;
+  bool aborted;
+
+  fpt_stats stats;
+};
+
+/* Allocate the scratch space of the exact solver for the graph G */
+struct fpt_workspace* fpt_workspace_create(const graph_data* G, prob_type type)
+{
+  struct fpt_workspace* ws = malloc(sizeof(struct fpt_workspace));
+  size_t len = (type == CVD) ? G->n : G->m;
+  assert(type == CVD || type == CD);
+  ws->type = type;
+  ws->state = calloc(len+1,sizeof(char));
+  ws->trail = malloc((len+1)*sizeof(int));
+  ws->trail_len = 0;
+  ws->hash = 0;
+  tt_init(&ws->memo,FPT_MEMO_LOG2SIZE);
+  ws->mark = calloc(len+1,sizeof(uint64_t));
+  ws->stamp = 0;
+  memset(&ws->stats,0,sizeof(fpt_stats));
+  return ws;
+}
+
+/* Free the scratch space of the exact solver */
+void fpt_workspace_destroy(struct fpt_workspace* ws)
+{
+  free(ws->state);
+  free(ws->trail);
+  tt_free(&ws->memo);
+  free(ws->mark);
+  free(ws);
+}
+
+/* Statistics of the exact solver */
+const fpt_stats* fpt_statistics(const context* ctx)
+{
+  return &ctx->fpt->stats;
+}
+
+/* Set the state of a free element */
+static void set_state(struct fpt_workspace* ws, int i, int s)
+{
+  assert(ws->state[i] == FREE);
+  ws->state[i] = s;
+  ws->trail[ws->trail_len++] = i;
+  ws->hash ^= fpt_key(i,s);
+}
+
+/* Free the elements set since the trail had length len */
+static void undo(struct fpt_workspace* ws, int len)
+{
+  while (ws->trail_len > len){
+    int i = ws->trail[--ws->trail_len];
+    ws->hash ^= fpt_key(i,ws->state[i]);
+    ws->state[i] = FREE;
+  }
+}
+
+/*
+ * Classify a conflict whose free elements are p[0..nfree-1]: a
+ * conflict without free elements cannot be resolved, one with a
+ * single free element forces its deletion, and the others are packed
+ * greedily (if disjoint from those packed so far) for a lower bound
+ * on the deletions still needed. The conflict with the fewest free
+ * elements is kept for branching.
+ */
+static int classify(struct fpt_workspace* ws, const int* p, int nfree, int budget, int* lb)
+{
+  int l;
+  if (nfree == 0 || (nfree == 1 && budget == 0)) return SCAN_FAIL;
+  if (nfree == 1){
+    set_state(ws,p[0],DELETED);
+    return SCAN_FORCED;
+  }
+  for (l=0; l<nfree && ws->mark[p[l]] != ws->stamp; l++);
+  if (l == nfree){
+    for (l=0; l<nfree; l++) ws->mark[p[l]] = ws->stamp;
+    if (++*lb > budget) return SCAN_FAIL;
+  }
+  if (ws->branch_len == 0 || nfree < ws->branch_len){
+    memcpy(ws->branch,p,nfree*sizeof(int));
+    ws->branch_len = nfree;
+  }
+  return SCAN_BRANCH;
+}
+
+/* Scan the P3s of G[V] minus the deleted vertices */
+static int cvd_scan(const chromosome* chr, int budget, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct fpt_workspace* ws = ctx->fpt;
+  int i, j, l, lb = 0;
+
+  ws->stamp++;
+  ws->branch_len = 0;
+  for (i=0; i<chr->cached_Vlist_len; i++){
+    int v = chr->cached_Vlist[i];
+    if (ws->state[v] == DELETED) continue;
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int u = src(G->p3_vlist[v][j]);
+      int w = snk(G->p3_vlist[v][j]);
+      int p[3], nfree = 0, r;
+      if (!ps_read(&chr->V,u) || ws->state[u] == DELETED || !ps_read(&chr->V,w) || ws->state[w] == DELETED) continue;
+      p[0] = v; p[1] = u; p[2] = w;
+      for (l=0; l<3; l++) if (ws->state[p[l]] == FREE) p[nfree++] = p[l];
+      r = classify(ws,p,nfree,budget,&lb);
+      if (r != SCAN_BRANCH) return r;
+    }
+  }
+  return ws->branch_len ? SCAN_BRANCH : SCAN_CLUSTER;
+}
+
+/* Is edge e in G[V] and not deleted? */
+static bool cd_present(int e, const chromosome* chr, const struct fpt_workspace* ws, const graph_data* G)
+{
+  return ws->state[e] != DELETED &&		\
+    ps_read(&chr->V,src(G->edge_list[e])) &&	\
+    ps_read(&chr->V,snk(G->edge_list[e]));
+}
+
+/*
+ * Scan the P3s of G[V] minus the deleted edges: pairs of edges whose
+ * third side is a non-edge of G or a deleted edge
+ */
+static int cd_scan(const chromosome* chr, int budget, context* ctx)
+{
+  const graph_data* G = ctx->G;
+  struct fpt_workspace* ws = ctx->fpt;
+  int i, j, l, lb = 0;
+
+  ws->stamp++;
+  ws->branch_len = 0;
+  for (i=0; i<chr->cached_Elist_len; i++){
+    int e = chr->cached_Elist[i];
+    if (ws->state[e] == DELETED) continue;
+    /* the P3 partners of e, then each triangle in both orientations */
+    for (j=0; j<G->p3_elist_len[e]+2*G->triangle_elist_len[e]; j++){
+      int f, g, p[2], nfree = 0, r;
+      if (j < G->p3_elist_len[e]) f = G->p3_elist[e][j];
+      else {
+	pair_t t = G->triangle_elist[e][(j - G->p3_elist_len[e]) >> 1];
+	f = ((j - G->p3_elist_len[e]) & 1) ? snk(t) : src(t);
+	g = ((j - G->p3_elist_len[e]) & 1) ? src(t) : snk(t);
+	if (ws->state[g] != DELETED) continue;
+      }
+      if (!cd_present(f,chr,ws,G)) continue;
+      p[0] = e; p[1] = f;
+      for (l=0; l<2; l++) if (ws->state[p[l]] == FREE) p[nfree++] = p[l];
+      r = classify(ws,p,nfree,budget,&lb);
+      if (r != SCAN_BRANCH) return r;
+    }
+  }
+  return ws->branch_len ? SCAN_BRANCH : SCAN_CLUSTER;
+}
+
+/*
+ * Search for at most budget deletions that leave G[V] a cluster
+ * graph, from the current states. On success the states hold the
+ * solution; on failure they are restored, and the budget is recorded
+ * as too small for this subproblem (unless the node limit was hit).
+ */
+static bool branch(const chromosome* chr, int budget, context* ctx)
+{
+  struct fpt_workspace* ws = ctx->fpt;
+  int top = ws->trail_len;
+  int entry = budget;
+  int i, r, len, failed, conflict[3];
+  uint64_t key;
+
+  if (++ws->nodes > FPT_NODE_LIMIT){
+    ws->aborted = true;
+    return false;
+  }
+  key = ws->hash ^ chr->hash_V;
+  if (tt_lookup(&ws->memo,key,&failed) && failed >= budget) return false;
+
+  /* make the forced deletions, then branch on the smallest conflict */
+  do {
+    r = (ws->type == CVD) ? cvd_scan(chr,budget,ctx) : cd_scan(chr,budget,ctx);
+    if (r == SCAN_FORCED) budget--;
+  } while (r == SCAN_FORCED);
+  if (r == SCAN_CLUSTER) return true;
+
+  if (r == SCAN_BRANCH){
+    len = ws->branch_len;
+    memcpy(conflict,ws->branch,len*sizeof(int));
+    for (i=0; i<len; i++){
+      int mark = ws->trail_len;
+      set_state(ws,conflict[i],DELETED);
+      if (branch(chr,budget-1,ctx)) return true;
+      undo(ws,mark);
+      if (ws->aborted) break;
+      /* the remaining branches keep this element */
+      set_state(ws,conflict[i],PERMANENT);
+    }
+  }
+  undo(ws,top);
+  if (!ws->aborted) tt_store(&ws->memo,key,entry);
+  return false;
+}
+
+/*
+ * Find a smallest set of elements of G[V] (vertices for CVD, edges
+ * for CD) whose deletion leaves a cluster graph, trying budgets
+ * 0,1,...,budget in turn. If there is one (and it is found within
+ * the node limit), it replaces chr->S and its size is returned (and
+ * cached as the fitness of chr); otherwise chr is left unchanged and
+ * FITNESS_INFEASIBLE is returned.
+ */
+int fpt_solve(chromosome* chr, int budget, context* ctx)
+{
+  struct fpt_workspace* ws = ctx->fpt;
+  bool found = false;
+  int b, i;
+
+  assert(ws != NULL && ws->trail_len == 0);
+  ws->stats.calls++;
+  ws->nodes = 0;
+  ws->aborted = false;
+  for (b=0; b<=budget && !found && !ws->aborted; b++) found = branch(chr,b,ctx);
+  ws->stats.nodes += ws->nodes;
+  if (ws->aborted) ws->stats.aborted++;
+
+  if (found){
+    ws->stats.solved++;
+    ps_zero(&chr->S);
+    for (i=0; i<ws->trail_len; i++){
+      if (ws->state[ws->trail[i]] == DELETED) ps_store(&chr->S,ws->trail[i]);
+    }
+    chromosome_rehash(chr);
+    chr->fitness = chr->inside = ps_popcount(&chr->S);
+  }
+  undo(ws,0);
+  return found ? chr->fitness : FITNESS_INFEASIBLE;
+}
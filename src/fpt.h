@@ -0,0 +1,41 @@
+/*
+ * Exact solver for CVD and CD on the subgraph G[V] of a chromosome: a
+ * bounded search tree branching on the P3s of G[V] (3 ways for CVD,
+ * 2 ways for CD), used on small components and on small offspring
+ * that the operators could not make feasible
+ */
+
+#ifndef FPT_H
+#define FPT_H
+
+#include <stdlib.h>
+
+#include "chromosome.h"
+#include "graph.h"
+#include "params.h"
+#include "context.h"
+
+/* Search tree nodes a single call may visit before giving up */
+#define FPT_NODE_LIMIT 100000
+
+/* log2 of the number of entries of the table of failed subproblems */
+#define FPT_MEMO_LOG2SIZE 14
+
+/*
+ * calls counts the searches, solved those that found a solution,
+ * aborted those that hit the node limit, and nodes the search tree
+ * nodes visited by all of them
+ */
+typedef struct {
+  size_t calls;
+  size_t solved;
+  size_t aborted;
+  size_t nodes;
+} fpt_stats;
+
+struct fpt_workspace* fpt_workspace_create(const graph_data* G, prob_type type);
+void fpt_workspace_destroy(struct fpt_workspace* ws);
+const fpt_stats* fpt_statistics(const context* ctx);
+int fpt_solve(chromosome* chr, int budget, context* ctx);
+
+#endif
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <assert.h>
 #include <lzma.h>
 #include <unistd.h>
 #include <error.h>
@@ -90,16 +91,25 @@ int read_graph(graph_data* G, FILE* file)
   G->edge_list    = malloc(G->m*sizeof(pair_t));
   G->adj_list     = malloc(G->n*sizeof(int*));
   G->adj_list_len = malloc(G->n*sizeof(int));
+  G->adj_elist    = malloc(G->n*sizeof(int*));
 
   G->p3_vlist     = malloc(G->n*sizeof(pair_t*));
   G->p3_vlist_len = malloc(G->n*sizeof(int));  
   for (i=0; i<G->n; i++){
     G->adj_list[i] = malloc(G->n*sizeof(int));
+    G->adj_elist[i] = malloc(G->n*sizeof(int));
     G->p3_vlist[i]  = malloc(G->m*sizeof(pair_t));
     G->adj_list_len[i] = 0;
     G->p3_vlist_len[i]  = 0;
   }
 
+  /* non-edges are only indexed on request (see index_nonedges) */
+  G->q = 0;
+  G->nonedge_list = NULL;
+  G->nadj_list = G->nadj_elist = NULL;
+  G->nadj_list_len = NULL;
+  G->p3_nlist = NULL;
+
   G->p3_elist     = malloc(G->m*sizeof(int*));
   G->p3_elist_len = malloc(G->m*sizeof(int));
   G->triangle_elist     = malloc(G->m*sizeof(pair_t*));
@@ -124,7 +134,9 @@ int read_graph(graph_data* G, FILE* file)
   /* Compute adjacency lists */
   debug("Computing adjacency lists...");
   for (i=0; i<G->m; i++){
+    G->adj_elist[src(G->edge_list[i])][G->adj_list_len[src(G->edge_list[i])]] = i;
     G->adj_list[src(G->edge_list[i])][G->adj_list_len[src(G->edge_list[i])]++] = snk(G->edge_list[i]);
+    G->adj_elist[snk(G->edge_list[i])][G->adj_list_len[snk(G->edge_list[i])]] = i;
     G->adj_list[snk(G->edge_list[i])][G->adj_list_len[snk(G->edge_list[i])]++] = src(G->edge_list[i]);
     //G->adj_list[edgebuf[2*i]][G->adj_list_len[edgebuf[2*i]]++] = edgebuf[2*i+1];
     //G->adj_list[edgebuf[2*i+1]][G->adj_list_len[edgebuf[2*i+1]]++] = edgebuf[2*i];
@@ -135,6 +147,13 @@ int read_graph(graph_data* G, FILE* file)
 
   /*  Compute vertex p3 lists */
   debug("Computing and storing vertex P3 lists...");
+  G->p3_mlist     = malloc(G->n*sizeof(pair_t*));
+  G->p3_mlist_len = malloc(G->n*sizeof(int));
+  for (i=0; i<G->n; i++){
+    /* at most one P3 per pair of neighbours has i in the middle */
+    G->p3_mlist[i] = malloc((G->adj_list_len[i]*(G->adj_list_len[i]-1)/2+1)*sizeof(pair_t));
+    G->p3_mlist_len[i] = 0;
+  }
   for (i=0; i<G->n; i++) {
     for (j=0; j<G->adj_list_len[i]; j++) {
       int v = i;
@@ -149,6 +168,7 @@ int read_graph(graph_data* G, FILE* file)
 	  }
 	  if (!triangle) {
 	    G->p3_vlist[v][G->p3_vlist_len[v]++] = make_pair(u,w);
+	    if (v < w) G->p3_mlist[u][G->p3_mlist_len[u]++] = make_pair(v,w);
 	    if(G->p3_vlist_len[v] > G->m){
 	      error(1,ERANGE,"vertex P3 list length");
 	    }
@@ -200,6 +220,128 @@ int read_graph(graph_data* G, FILE* file)
   return G->n;
 }
 
+/*
+ * Index the candidate insertions of cluster editing: the non-edges
+ * {u,w} that close some P3 u-v-w of G. Fills nonedge_list, the
+ * per-vertex lists nadj_list/nadj_elist (as for adj_list/adj_elist)
+ * and p3_nlist, which names the non-edge closing each P3 of p3_elist.
+ *
+ * Returns the number of non-edges q
+ */
+int index_nonedges(graph_data* G)
+{
+  int i, j, v;
+  int* mark = malloc(G->n*sizeof(int));
+
+  debug("Indexing non-edges in P3s...");
+  G->nadj_list     = malloc(G->n*sizeof(int*));
+  G->nadj_elist    = malloc(G->n*sizeof(int*));
+  G->nadj_list_len = calloc(G->n,sizeof(int));
+  G->q = 0;
+  for (v=0; v<G->n; v++) mark[v] = -1;
+
+  /* count the non-edges of each vertex, so the lists can be sized */
+  for (v=0; v<G->n; v++){
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int w = snk(G->p3_vlist[v][j]);
+      if (mark[w] != v) {
+	mark[w] = v;
+	G->nadj_list_len[v]++;
+      }
+    }
+  }
+  for (v=0; v<G->n; v++){
+    G->nadj_list[v] = malloc((G->nadj_list_len[v]+1)*sizeof(int));
+    G->nadj_elist[v] = malloc((G->nadj_list_len[v]+1)*sizeof(int));
+    G->q += G->nadj_list_len[v];
+    G->nadj_list_len[v] = 0;
+    mark[v] = -1;
+  }
+  G->q /= 2;
+  G->nonedge_list = malloc((G->q+1)*sizeof(pair_t));
+
+  /* number the non-edges {v,w} from the lower endpoint v */
+  G->q = 0;
+  for (v=0; v<G->n; v++){
+    for (j=0; j<G->p3_vlist_len[v]; j++){
+      int w = snk(G->p3_vlist[v][j]);
+      if (v < w && mark[w] != v) {
+	mark[w] = v;
+	G->nonedge_list[G->q] = make_pair(v,w);
+	G->nadj_elist[v][G->nadj_list_len[v]] = G->q;
+	G->nadj_list[v][G->nadj_list_len[v]++] = w;
+	G->nadj_elist[w][G->nadj_list_len[w]] = G->q;
+	G->nadj_list[w][G->nadj_list_len[w]++] = v;
+	G->q++;
+      }
+    }
+  }
+
+  /* the non-edge closing each P3 (e,f): join the ends not shared */
+  G->p3_nlist = malloc(G->m*sizeof(int*));
+  for (i=0; i<G->m; i++){
+    int a = src(G->edge_list[i]);
+    int b = snk(G->edge_list[i]);
+    G->p3_nlist[i] = malloc((G->p3_elist_len[i]+1)*sizeof(int));
+    for (j=0; j<G->p3_elist_len[i]; j++){
+      int f = G->p3_elist[i][j];
+      int c = src(G->edge_list[f]);
+      int d = snk(G->edge_list[f]);
+      int x = (c == a || d == a) ? b : a;
+      int y = (c == a || c == b) ? d : c;
+      int l;
+      G->p3_nlist[i][j] = -1;
+      for (l=0; l<G->nadj_list_len[x]; l++){
+	if (G->nadj_list[x][l] == y) G->p3_nlist[i][j] = G->nadj_elist[x][l];
+      }
+      assert(G->p3_nlist[i][j] >= 0);
+    }
+  }
+
+  free(mark);
+  return G->q;
+}
+
+/*
+ * List the vertices of G in order of decreasing degree (ties in
+ * increasing order), by counting sort
+ */
+void vertices_by_degree(int* order, const graph_data* G)
+{
+  int v, d, maxdeg = 0;
+  int* start;
+
+  for (v=0; v<G->n; v++) if (G->adj_list_len[v] > maxdeg) maxdeg = G->adj_list_len[v];
+  start = calloc(maxdeg+2,sizeof(int));
+  for (v=0; v<G->n; v++) start[maxdeg - G->adj_list_len[v] + 1]++;
+  for (d=1; d<=maxdeg+1; d++) start[d] += start[d-1];
+  for (v=0; v<G->n; v++) order[start[maxdeg - G->adj_list_len[v]]++] = v;
+  free(start);
+}
+
+/*
+ * Lower bound on the size of a solution for CVD, CD and CEP: the
+ * number of vertex-disjoint P3s in a greedy packing, as every P3
+ * needs its own vertex deletion or edge edit
+ */
+int p3_packing(const graph_data* G)
+{
+  char* used = calloc(G->n,sizeof(char));
+  int v, j, count = 0;
+
+  for (v=0; v<G->n; v++){
+    for (j=0; j<G->p3_mlist_len[v] && !used[v]; j++){
+      int u = src(G->p3_mlist[v][j]);
+      int w = snk(G->p3_mlist[v][j]);
+      if (used[u] || used[w]) continue;
+      used[u] = used[v] = used[w] = 1;
+      count++;
+    }
+  }
+  free(used);
+  return count;
+}
+
 /*
  * Read a list of edges from a plaintext file, storing in edgebuf
  *
@@ -333,7 +475,9 @@ void free_graph(graph_data* G)
   debug("Freeing memory...");
   for (i=0; i<G->n; i++){
     free(G->adj_list[i]);
+    free(G->adj_elist[i]);
     free(G->p3_vlist[i]);
+    free(G->p3_mlist[i]);
   }
   for (i=0; i<G->m; i++){
     free(G->p3_elist[i]);
@@ -341,10 +485,27 @@ void free_graph(graph_data* G)
   free(G->edge_list);
   free(G->adj_list);
   free(G->adj_list_len);
+  free(G->adj_elist);
   free(G->p3_vlist);
   free(G->p3_vlist_len);
+  free(G->p3_mlist);
+  free(G->p3_mlist_len);
   free(G->p3_elist);
   free(G->p3_elist_len);
+  if (G->nadj_list) {
+    for (i=0; i<G->n; i++){
+      free(G->nadj_list[i]);
+      free(G->nadj_elist[i]);
+    }
+    for (i=0; i<G->m; i++){
+      free(G->p3_nlist[i]);
+    }
+    free(G->nonedge_list);
+    free(G->nadj_list);
+    free(G->nadj_elist);
+    free(G->nadj_list_len);
+    free(G->p3_nlist);
+  }
 }
 
 
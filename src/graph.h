@@ -27,9 +27,13 @@ typedef int pair_t;
  * edge_list - a list of m pairs containing the edges
  * adj_list[v] adjacency list for vertex v
  * adj_list_len[v] length of adjacency list for vertex v
+ * adj_elist[v][i] index of the edge joining v and adj_list[v][i]
  * 
  * p3_vlist[v] list of P3s (pairs u,w) for vertex v
  * p3_vlist_len[v] length of p3_vlist for v
+ *
+ * p3_mlist[v] list of P3s (pairs u,w with u < w) with v in the middle
+ * p3_mlist_len[v] length of p3_mlist for v
  * 
  * p3_elist[e] list of P3 partners (edge f for P3 e,f) for edge e
  * p3_elist_len[e] length of p3_elist for edge e
@@ -37,6 +41,14 @@ typedef int pair_t;
  * triangle_elist[e] a list of pairs (f,g) where edges e-f-g form a triangle
  * triangle_elist_len[e] length of triangle_elist for edge e
  *
+ * Only after index_nonedges (otherwise q = 0 and the lists are NULL):
+ *
+ * q - number of non-edges {u,w} closing some P3 u-v-w
+ * nonedge_list - a list of q pairs containing these non-edges
+ * nadj_list[v], nadj_elist[v], nadj_list_len[v] as adj_list, adj_elist
+ *   and adj_list_len, for the non-edges at v
+ * p3_nlist[e][i] index of the non-edge closing the P3 e,p3_elist[e][i]
+ *
  */
 typedef struct {
   int n, m, k;
@@ -45,20 +57,37 @@ typedef struct {
   
   int** adj_list;
   int*  adj_list_len;
+  int** adj_elist;
   
   pair_t** p3_vlist;
   int*     p3_vlist_len;
 
+  pair_t** p3_mlist;
+  int*     p3_mlist_len;
+
   int** p3_elist;
   int*  p3_elist_len;
 
   pair_t** triangle_elist;
   int*     triangle_elist_len;
+
+  int q;
+  pair_t* nonedge_list;
+  int** nadj_list;
+  int*  nadj_list_len;
+  int** nadj_elist;
+  int** p3_nlist;
 } graph_data;
 
 
 int read_graph(graph_data* G, FILE* file);
 
+int index_nonedges(graph_data* G);
+
+void vertices_by_degree(int* order, const graph_data* G);
+
+int p3_packing(const graph_data* G);
+
 int read_edges_from_plaintext(int* edgebuf, const int bufsize, FILE* file);
 
 int read_edges_from_compressed(int* edgebuf, const int bufsize, FILE* file);
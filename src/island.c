@@ -0,0 +1,36 @@
+#include <stdlib.h>
+
+#include "graph.h"
+#include "params.h"
+#include "context.h"
+#include "migration.h"
+#include "run.h"
+#include "race.h"
+#include "island.h"
+
+/* Create count islands for the problem on G set by prm */
+void islands_init(islands* is, const graph_data* G, const params* prm, int count)
+{
+  race* r = &is->r;
+  int i;
+
+  race_init(r,count);
+  is->queue = malloc(count*sizeof(migration_queue));
+  for (i=0; i<count; i++){
+    run_init(&r->rs[i],G,prm,i);
+    context_parallel(r->rs[i].ctx,prm->threads);
+    mq_init(&is->queue[i],r->rs[i].ctx->setlen,G);
+  }
+  for (i=0; i<count; i++){
+    run_connect(&r->rs[i],&r->stop,&is->queue[i],&is->queue[(i+1) % count]);
+  }
+}
+
+/* Free the islands */
+void islands_free(islands* is)
+{
+  int i;
+  for (i=0; i<is->r.count; i++) mq_free(&is->queue[i]);
+  race_free(&is->r);
+  free(is->queue);
+}
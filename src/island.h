@@ -0,0 +1,33 @@
+/*
+ * Island model: a race of runs with the same settings, with the
+ * generators split off one seed, passing chromosomes around a ring of
+ * migration queues
+ */
+
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include <stdlib.h>
+
+#include "graph.h"
+#include "params.h"
+#include "migration.h"
+#include "run.h"
+#include "race.h"
+
+/*
+ * island i is r.rs[i], which receives from queue[i] and sends to
+ * queue[(i+1) % r.count]
+ */
+typedef struct {
+  race r;
+  migration_queue* queue;
+} islands;
+
+/* Create count islands for the problem on G set by prm */
+void islands_init(islands* is, const graph_data* G, const params* prm, int count);
+
+/* Free the islands */
+void islands_free(islands* is);
+
+#endif
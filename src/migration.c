@@ -0,0 +1,59 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "graph.h"
+#include "chromosome.h"
+#include "migration.h"
+
+/* Initialize an empty queue for chromosomes of solution size len on G */
+void mq_init(migration_queue* q, size_t len, const graph_data* G)
+{
+  int i;
+  for (i=0; i<MIGRATION_SLOTS; i++) chromosome_init(&q->slot[i],len,G);
+  atomic_init(&q->head,0);
+  atomic_init(&q->tail,0);
+  q->sent = q->dropped = q->received = 0;
+}
+
+/* Free the slots of the queue */
+void mq_free(migration_queue* q)
+{
+  int i;
+  for (i=0; i<MIGRATION_SLOTS; i++) chromosome_free(&q->slot[i]);
+}
+
+/*
+ * Push a copy of chr; returns false (dropping it) if the queue is
+ * full. The slot is filled before tail is published, so the receiver
+ * never sees a partial copy.
+ */
+bool mq_push(migration_queue* q, const chromosome* chr)
+{
+  size_t tail = atomic_load_explicit(&q->tail,memory_order_relaxed);
+  size_t head = atomic_load_explicit(&q->head,memory_order_acquire);
+  if (tail - head == MIGRATION_SLOTS){
+    q->dropped++;
+    return false;
+  }
+  chromosome_copy(&q->slot[tail % MIGRATION_SLOTS],chr);
+  atomic_store_explicit(&q->tail,tail+1,memory_order_release);
+  q->sent++;
+  return true;
+}
+
+/*
+ * Pop the oldest migrant into chr; returns false if there is none.
+ * The slot is copied out before head is published, so the sender
+ * never overwrites it too early.
+ */
+bool mq_pop(migration_queue* q, chromosome* chr)
+{
+  size_t head = atomic_load_explicit(&q->head,memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&q->tail,memory_order_acquire);
+  if (head == tail) return false;
+  chromosome_copy(chr,&q->slot[head % MIGRATION_SLOTS]);
+  atomic_store_explicit(&q->head,head+1,memory_order_release);
+  q->received++;
+  return true;
+}
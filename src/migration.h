@@ -0,0 +1,50 @@
+/*
+ * Lock-free queue of migrant chromosomes between two islands: one
+ * island pushes copies of its chromosomes and the next one pops them.
+ * The slots are allocated up front, so migration never allocates.
+ */
+
+#ifndef MIGRATION_H
+#define MIGRATION_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "graph.h"
+#include "chromosome.h"
+
+/* Chromosomes a queue can hold (pushes to a full queue are dropped) */
+#define MIGRATION_SLOTS 4
+
+/* Generations between the migrations of an island */
+#define MIGRATION_INTERVAL 1000
+
+/*
+ * slot[head % MIGRATION_SLOTS .. (tail-1) % MIGRATION_SLOTS] hold the
+ * migrants waiting; only the sender moves tail and only the receiver
+ * moves head. sent and dropped are counted by the sender, received by
+ * the receiver.
+ */
+typedef struct {
+  chromosome slot[MIGRATION_SLOTS];
+  atomic_size_t head;
+  atomic_size_t tail;
+  size_t sent;
+  size_t dropped;
+  size_t received;
+} migration_queue;
+
+/* Initialize an empty queue for chromosomes of solution size len on G */
+void mq_init(migration_queue* q, size_t len, const graph_data* G);
+
+/* Free the slots of the queue */
+void mq_free(migration_queue* q);
+
+/* Push a copy of chr; returns false (dropping it) if the queue is full */
+bool mq_push(migration_queue* q, const chromosome* chr);
+
+/* Pop the oldest migrant into chr; returns false if there is none */
+bool mq_pop(migration_queue* q, chromosome* chr);
+
+#endif
@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include "packed_set.h"
+#include "graph.h"
+#include "params.h"
+#include "context.h"
+#include "run.h"
+#include "minimize.h"
+
+/*
+ * Sets stop once the deadline passes, unless told to quit first
+ * (through quit, under lock)
+ */
+struct watchdog {
+  pthread_t tid;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  struct timespec deadline;
+  bool quit;
+  atomic_bool stop;
+};
+
+static void* watchdog_main(void* p)
+{
+  struct watchdog* wd = p;
+  int rc = 0;
+  pthread_mutex_lock(&wd->lock);
+  while (!wd->quit && rc != ETIMEDOUT) rc = pthread_cond_timedwait(&wd->wake,&wd->lock,&wd->deadline);
+  if (!wd->quit) atomic_store(&wd->stop,true);
+  pthread_mutex_unlock(&wd->lock);
+  return NULL;
+}
+
+/* Seconds on the monotonic clock */
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+/*
+ * Search from the budget of rs downwards, running each attempt for at
+ * most prm->cutoff generations and all of them for at most
+ * prm->time_limit seconds (if not 0), writing a result line per
+ * attempt (type is the problem's name) to out
+ */
+void minimize(run_state* rs, const params* prm, const char* typestr, FILE* out, minimize_result* mr)
+{
+  const graph_data* G = rs->ctx->G;
+  struct watchdog wd;
+  double start = now();
+
+  mr->lower = p3_packing(G);
+  mr->best = -1;
+  ps_init(&mr->S,rs->ctx->setlen);
+  mr->attempts = 0;
+  mr->timed_out = false;
+  fprintf(stderr,"Minimize: lower bound %d (disjoint P3s)\n",mr->lower);
+
+  /* the watchdog stops the run through the race stop flag */
+  atomic_init(&wd.stop,false);
+  if (prm->time_limit > 0){
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+    pthread_cond_init(&wd.wake,&attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&wd.lock,NULL);
+    clock_gettime(CLOCK_MONOTONIC,&wd.deadline);
+    wd.deadline.tv_sec += (time_t)prm->time_limit;
+    wd.quit = false;
+    pthread_create(&wd.tid,NULL,watchdog_main,&wd);
+  }
+  run_connect(rs,&wd.stop,NULL,NULL);
+
+  for (;;){
+    size_t t0 = rs->t;
+    int size;
+
+    rs->cutoff = rs->t + prm->cutoff;
+    run_solve(rs);
+    mr->attempts++;
+    fprintf(out,"%s,%d,%d,%d,%s,%lu,%d,%lu,%lu\n",prm->input_filename,G->n,G->m,rs->ctx->k,typestr,
+	    rs->t - t0,rs->solved,rs->popsize,prm->cutoff);
+    fflush(out);
+    if (!rs->solved){
+      mr->timed_out = atomic_load(&wd.stop);
+      fprintf(stderr,"Minimize: k=%d %s after %lu generations (%.2fs)\n",rs->ctx->k,
+	      mr->timed_out ? "stopped by the time limit" : "unsolved",rs->t - t0,now() - start);
+      break;
+    }
+
+    size = ps_popcount(&rs->P[0]->S);
+    mr->best = size;
+    ps_copy(&mr->S,&rs->P[0]->S);
+    fprintf(stderr,"Minimize: k=%d solved with a solution of size %d after %lu generations (%.2fs)\n",
+	    rs->ctx->k,size,rs->t - t0,now() - start);
+    if (size <= mr->lower) break;
+
+    /* continue one below the solution from its clusters */
+    run_set_budget(rs,size - 1);
+    run_resplit(rs);
+    fprintf(stderr,"Minimize: continuing at k=%d from %lu clusters\n",size - 1,rs->popsize);
+  }
+
+  run_connect(rs,NULL,NULL,NULL);
+  if (prm->time_limit > 0){
+    pthread_mutex_lock(&wd.lock);
+    wd.quit = true;
+    pthread_cond_signal(&wd.wake);
+    pthread_mutex_unlock(&wd.lock);
+    pthread_join(wd.tid,NULL);
+    pthread_mutex_destroy(&wd.lock);
+    pthread_cond_destroy(&wd.wake);
+  }
+}
+
+/* Free the result */
+void minimize_free(minimize_result* mr)
+{
+  ps_free(&mr->S);
+}
@@ -0,0 +1,45 @@
+/*
+ * Minimum-k search: solve at the given budget, then lower the budget
+ * to one less than the size of the solution found and continue from
+ * the population split back into the clusters of that solution, until
+ * the solution reaches a lower bound, an attempt fails or the time
+ * budget runs out
+ */
+
+#ifndef MINIMIZE_H
+#define MINIMIZE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "packed_set.h"
+#include "params.h"
+#include "run.h"
+
+/*
+ * lower is the lower bound (see p3_packing), best the size of the
+ * smallest solution found (-1 if none) and S that solution; attempts
+ * counts the budgets tried, and timed_out records whether the time
+ * budget ran out
+ */
+typedef struct {
+  int lower;
+  int best;
+  packed_set S;
+  int attempts;
+  bool timed_out;
+} minimize_result;
+
+/*
+ * Search from the budget of rs downwards, running each attempt for at
+ * most prm->cutoff generations and all of them for at most
+ * prm->time_limit seconds (if not 0), writing a result line per
+ * attempt (type is the problem's name) to out
+ */
+void minimize(run_state* rs, const params* prm, const char* typestr, FILE* out, minimize_result* mr);
+
+/* Free the result */
+void minimize_free(minimize_result* mr);
+
+#endif
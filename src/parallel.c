@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <assert.h>
+
+#include "alloc_debug.h"
+#include "parallel.h"
+
+/*
+ * Threads 1..threads-1 wait for round to change, run the current scan
+ * and report in found; pending counts those still scanning
+ */
+struct par_pool {
+  int threads;
+  pthread_t tid[PAR_MAX_THREADS];
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long round;
+  int pending;
+  bool quit;
+
+  /* the current scan */
+  par_scan_fn fn;
+  void* arg;
+  bool found[PAR_MAX_THREADS];
+  atomic_bool stop;
+#ifdef ALLOC_DEBUG
+  /* the workers' allocations count as the caller's */
+  atomic_size_t* counter;
+#endif
+};
+
+/* Arguments of a worker thread */
+struct par_worker {
+  par_pool* pool;
+  int first;
+};
+
+static void* par_worker_main(void* p)
+{
+  struct par_worker* w = p;
+  par_pool* pool = w->pool;
+  int first = w->first;
+  unsigned long seen = 0;
+
+  free(w);
+  for (;;){
+    bool found;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->round == seen && !pool->quit) pthread_cond_wait(&pool->start,&pool->lock);
+    if (pool->quit){
+      pthread_mutex_unlock(&pool->lock);
+      return NULL;
+    }
+    seen = pool->round;
+    pthread_mutex_unlock(&pool->lock);
+
+#ifdef ALLOC_DEBUG
+    alloc_charge(pool->counter);
+#endif
+    found = pool->fn(first,pool->threads,pool->arg,&pool->stop);
+    if (found) atomic_store(&pool->stop,true);
+#ifdef ALLOC_DEBUG
+    alloc_charge(NULL);
+#endif
+
+    pthread_mutex_lock(&pool->lock);
+    pool->found[first] = found;
+    if (--pool->pending == 0) pthread_cond_signal(&pool->done);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+/* Start a pool of threads (the caller counts as one of them) */
+par_pool* par_create(int threads)
+{
+  par_pool* pool = malloc(sizeof(par_pool));
+  int i;
+
+  assert(threads >= 1 && threads <= PAR_MAX_THREADS);
+  pool->threads = threads;
+  pthread_mutex_init(&pool->lock,NULL);
+  pthread_cond_init(&pool->start,NULL);
+  pthread_cond_init(&pool->done,NULL);
+  pool->round = 0;
+  pool->pending = 0;
+  pool->quit = false;
+  atomic_init(&pool->stop,false);
+  for (i=1; i<threads; i++){
+    struct par_worker* w = malloc(sizeof(struct par_worker));
+    w->pool = pool;
+    w->first = i;
+    pthread_create(&pool->tid[i],NULL,par_worker_main,w);
+  }
+  return pool;
+}
+
+/* Stop the threads and free the pool */
+void par_destroy(par_pool* pool)
+{
+  int i;
+  pthread_mutex_lock(&pool->lock);
+  pool->quit = true;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+  for (i=1; i<pool->threads; i++) pthread_join(pool->tid[i],NULL);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->start);
+  pthread_cond_destroy(&pool->done);
+  free(pool);
+}
+
+/* Number of threads of the pool */
+int par_threads(const par_pool* pool)
+{
+  return pool->threads;
+}
+
+/*
+ * Run fn on every thread of the pool, each taking every threads-th
+ * index; returns the lowest thread whose scan returned true, or -1 if
+ * none did
+ */
+int par_any(par_pool* pool, par_scan_fn fn, void* arg)
+{
+  int i;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->fn = fn;
+  pool->arg = arg;
+#ifdef ALLOC_DEBUG
+  pool->counter = alloc_counter();
+#endif
+  atomic_store(&pool->stop,false);
+  pool->pending = pool->threads - 1;
+  pool->round++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  /* the caller scans the first share */
+  pool->found[0] = fn(0,pool->threads,arg,&pool->stop);
+  if (pool->found[0]) atomic_store(&pool->stop,true);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0) pthread_cond_wait(&pool->done,&pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (i=0; i<pool->threads; i++){
+    if (pool->found[i]) return i;
+  }
+  return -1;
+}
@@ -0,0 +1,48 @@
+/*
+ * Pool of worker threads that split a scan over a range of indices
+ * and stop as soon as one of them finds what the scan looks for (a
+ * violated P3 in the feasibility tests)
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* Largest number of threads in a pool */
+#define PAR_MAX_THREADS 64
+
+/* Smallest |V| for which the feasibility tests scan in parallel */
+#ifndef PAR_MIN_VERTICES
+#define PAR_MIN_VERTICES 2048
+#endif
+
+/*
+ * A scan visits the indices first, first+step, ... of its range and
+ * returns true if it found what it was looking for; it should return
+ * false as soon as it sees *stop set. first also numbers the thread
+ * (0 is the caller), for results kept per thread.
+ */
+typedef bool (*par_scan_fn)(int first, int step, void* arg, const atomic_bool* stop);
+
+typedef struct par_pool par_pool;
+
+/* Start a pool of threads (the caller counts as one of them) */
+par_pool* par_create(int threads);
+
+/* Stop the threads and free the pool */
+void par_destroy(par_pool* pool);
+
+/* Number of threads of the pool */
+int par_threads(const par_pool* pool);
+
+/*
+ * Run fn on every thread of the pool, each taking every threads-th
+ * index; returns the lowest thread whose scan returned true, or -1 if
+ * none did
+ */
+int par_any(par_pool* pool, par_scan_fn fn, void* arg);
+
+#endif
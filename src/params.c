@@ -1,8 +1,12 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <argp.h>
 
 #include "params.h"
+#include "parallel.h"
+#include "run.h"
+#include "race.h"
 
 
 static char doc[] = "\nSubgraph-Population Genetic Algorithm (subpopga)\n"\
@@ -50,7 +54,136 @@ static struct argp_option options[] = {
     .doc   = "save solution in file (if found)",
     .group = 1
   },
+  {
+    .name  = 0,
+    .key   = 'b',
+    .arg   = "<batch>",
+    .flags = 0,
+    .doc   = "evaluate mutants in bit-sliced batches of this size (1-64, default 1)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'x',
+    .arg   = "<size>",
+    .flags = 0,
+    .doc   = "solve components and failed offspring with at most this many vertices exactly (cvd and cd, default 0: never)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'g',
+    .arg   = NULL,
+    .flags = 0,
+    .doc   = "seed the population from a greedy solution instead of random sets",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'p',
+    .arg   = "<scheme>",
+    .flags = 0,
+    .doc   = "choose crossover partners: uniform | adjacent (owners of a random edge between two chromosomes), default uniform",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'a',
+    .arg   = NULL,
+    .flags = 0,
+    .doc   = "adapt the crossover probability and mutation rate to their acceptance rates (logging the trajectory)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'j',
+    .arg   = "<threads>",
+    .flags = 0,
+    .doc   = "split the feasibility tests of large chromosomes (cvd and cd) across this many threads (1-64, default 1)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'I',
+    .arg   = "<islands>",
+    .flags = 0,
+    .doc   = "run this many populations on their own threads, migrating chromosomes around a ring, until one is solved (1-64, default 1)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'w',
+    .arg   = "<width>",
+    .flags = 0,
+    .doc   = "generate and evaluate this many offspring at once (on the -j threads) from the population as it stands, then commit them in order (1-64, default 1)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'P',
+    .arg   = "<options>",
+    .flags = 0,
+    .doc   = "add a portfolio configuration: the given options (e.g. \"-g -p adjacent\") on top of the others; the configurations race on their own threads until one is solved (up to 64)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'r',
+    .arg   = "<seed>",
+    .flags = 0,
+    .doc   = "seed the random number generators (default: from the system's entropy)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'K',
+    .arg   = "<k,...>",
+    .flags = 0,
+    .doc   = "sweep: run a job for each of these solution sizes (and each -R seed), printing a result line per job",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'R',
+    .arg   = "<seed,...>",
+    .flags = 0,
+    .doc   = "sweep: run a job for each of these seeds (and each -K solution size)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'm',
+    .arg   = "<file>",
+    .flags = 0,
+    .doc   = "sweep: run a job for each line \"k seed\" of the file",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'T',
+    .arg   = "<threads>",
+    .flags = 0,
+    .doc   = "sweep: run this many jobs at once (1-64, default 1)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'M',
+    .arg   = NULL,
+    .flags = 0,
+    .doc   = "search for the smallest k: after solving, lower k to one less than the solution size and continue from the solution's clusters, until a lower bound is reached or an attempt fails (a result line per attempt)",
+    .group = 1
+  },
+  {
+    .name  = 0,
+    .key   = 'L',
+    .arg   = "<seconds>",
+    .flags = 0,
+    .doc   = "stop the search for the smallest k after this many seconds (default: no limit)",
+    .group = 1
+  },
   { NULL, 'h', 0, OPTION_HIDDEN, NULL, -1 },  
+  { 0 }
 };
 
 void init_params(params* prm)
@@ -59,6 +192,23 @@ void init_params(params* prm)
   prm->solution_filename = NULL;
   prm->k = 0;
   prm->cutoff = 0;
+  prm->batch = 1;
+  prm->exact = 0;
+  prm->greedy = false;
+  prm->select = SELECT_UNIFORM;
+  prm->adaptive = false;
+  prm->threads = 1;
+  prm->islands = 1;
+  prm->width = 1;
+  prm->portfolio_len = 0;
+  prm->seed = 0;
+  prm->seeded = false;
+  prm->sweep_k = NULL;
+  prm->sweep_seeds = NULL;
+  prm->manifest = NULL;
+  prm->sweep_threads = 1;
+  prm->minimize = false;
+  prm->time_limit = 0;
   prm->type = NONE;
   prm->save_solution = false;
 }
@@ -82,6 +232,107 @@ static error_t parse_opt (int key, char *arg, struct argp_state *state)
   case 'c':
     prm->cutoff = atoi(arg);
     break;
+  case 'b':
+    prm->batch = atoi(arg);
+    if (prm->batch < 1 || prm->batch > 64){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: batch size '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'x':
+    prm->exact = atoi(arg);
+    break;
+  case 'g':
+    prm->greedy = true;
+    break;
+  case 'j':
+    prm->threads = atoi(arg);
+    if (prm->threads < 1 || prm->threads > PAR_MAX_THREADS){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: thread count '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'I':
+    prm->islands = atoi(arg);
+    if (prm->islands < 1 || prm->islands > RACE_MAX){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: island count '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'w':
+    prm->width = atoi(arg);
+    if (prm->width < 1 || prm->width > SPEC_MAX_WIDTH){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: speculation width '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'P':
+    if (prm->portfolio_len == PORTFOLIO_MAX){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: more than %d portfolio configurations",PORTFOLIO_MAX);
+      return EINVAL;
+    }
+    prm->portfolio[prm->portfolio_len++] = arg;
+    break;
+  case 'r':
+    prm->seed = strtoull(arg,NULL,10);
+    prm->seeded = true;
+    break;
+  case 'K':
+    prm->sweep_k = arg;
+    break;
+  case 'R':
+    prm->sweep_seeds = arg;
+    break;
+  case 'm':
+    prm->manifest = arg;
+    break;
+  case 'T':
+    prm->sweep_threads = atoi(arg);
+    if (prm->sweep_threads < 1 || prm->sweep_threads > PAR_MAX_THREADS){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: sweep thread count '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'M':
+    prm->minimize = true;
+    break;
+  case 'L':
+    prm->time_limit = atof(arg);
+    if (prm->time_limit <= 0){
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: time limit '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
+  case 'a':
+    prm->adaptive = true;
+    break;
+  case 'p':
+    if (strcmp(arg,"uniform") == 0){
+      prm->select = SELECT_UNIFORM;
+    }
+    else if (strcmp(arg,"adjacent") == 0){
+      prm->select = SELECT_ADJACENT;
+    }
+    else {
+      fprintf(state->err_stream,"\n");
+      argp_failure(state,0,EINVAL,"ERROR: selection scheme '%s'",arg);
+      argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
+      return EINVAL;
+    }
+    break;
   case 't':
     if (strcmp(arg,"cvd") == 0){
       prm->type = CVD;
@@ -115,7 +366,7 @@ static error_t parse_opt (int key, char *arg, struct argp_state *state)
       argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
       return EINVAL;
     }
-    if (!prm->k){
+    if (!prm->k && !prm->sweep_k && !prm->manifest){
       fprintf(state->err_stream,"\n");
       argp_failure(state,0,0,"ERROR: missing k value");
       argp_state_help(state, state->out_stream, ARGP_HELP_STD_HELP);
@@ -149,3 +400,69 @@ bool set_params_from_args(params* prm, int argc, char** argv)
   
   return true;
 }
+
+/*
+ * Set prm to base with the options in the string str (separated
+ * by blanks) applied on top, for a portfolio configuration; these may
+ * only change the solver settings, not the instance, the output or
+ * the portfolio itself
+ */
+void set_params_from_string(params* prm, const params* base, const char* str)
+{
+  struct argp argp = { options, parse_opt, 0, doc, 0, 0, 0 };
+  char* copy = strdup(str);
+  char** argv = malloc((strlen(str)/2+2)*sizeof(char*));
+  char* tok;
+  int argc = 0;
+
+  argv[argc++] = "subpopga";
+  for (tok=strtok(copy," \t"); tok; tok=strtok(NULL," \t")) argv[argc++] = tok;
+  *prm = *base;
+  argp_parse(&argp,argc,argv,ARGP_NO_ARGS,0,prm);
+  if (prm->input_filename != base->input_filename || prm->type != base->type || prm->k != base->k ||
+      prm->solution_filename != base->solution_filename || prm->islands != base->islands ||
+      prm->portfolio_len != base->portfolio_len){
+    fprintf(stderr,"ERROR: portfolio configuration '%s' may only change the solver settings\n",str);
+    exit(EXIT_FAILURE);
+  }
+  free(argv);
+  free(copy);
+}
+
+/* Reject combinations of settings that are not supported */
+void check_params(const params* prm)
+{
+  if (prm->width > 1 && prm->batch > 1){
+    fprintf(stderr,"ERROR: speculative offspring (-w) cannot be combined with batch evaluation (-b)\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->portfolio_len > 0 && prm->islands > 1){
+    fprintf(stderr,"ERROR: a portfolio (-P) cannot be combined with islands (-I)\n");
+    exit(EXIT_FAILURE);
+  }
+  if ((prm->sweep_k || prm->sweep_seeds || prm->manifest) &&
+      (prm->portfolio_len > 0 || prm->islands > 1 || prm->save_solution)){
+    fprintf(stderr,"ERROR: a sweep (-K, -R, -m) cannot be combined with a portfolio (-P), islands (-I) or saving the solution (-s)\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->minimize && (prm->portfolio_len > 0 || prm->islands > 1 || prm->sweep_k || prm->sweep_seeds || prm->manifest)){
+    fprintf(stderr,"ERROR: the search for the smallest k (-M) cannot be combined with a portfolio (-P), islands (-I) or a sweep\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->time_limit > 0 && !prm->minimize){
+    fprintf(stderr,"ERROR: a time limit (-L) only applies to the search for the smallest k (-M)\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->manifest && (prm->sweep_k || prm->sweep_seeds)){
+    fprintf(stderr,"ERROR: a sweep manifest (-m) cannot be combined with lists of k values (-K) or seeds (-R)\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->type == CEP && prm->batch > 1){
+    fprintf(stderr,"ERROR: batch evaluation is not supported for cep\n");
+    exit(EXIT_FAILURE);
+  }
+  if (prm->type == CEP && prm->exact > 0){
+    fprintf(stderr,"ERROR: exact solving is not supported for cep\n");
+    exit(EXIT_FAILURE);
+  }
+}
@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <argp.h>
 
 
@@ -10,16 +11,56 @@ typedef enum {
   NONE, CVD, CD, CEP
 } prob_type;
 
+/* How crossover partners are chosen */
+typedef enum {
+  SELECT_UNIFORM, SELECT_ADJACENT
+} select_type;
+
+/* Largest number of portfolio configurations */
+#define PORTFOLIO_MAX 64
+
+/*
+ * portfolio[0..portfolio_len-1] are the option strings of the
+ * configurations of a portfolio run (see set_params_from_string)
+ *
+ * seed seeds the random number generators if seeded is set. A sweep
+ * runs a job for every k in the list sweep_k and every seed in the
+ * list sweep_seeds (comma-separated), or for every line "k seed" of
+ * the file manifest, on sweep_threads threads (see sweep.h)
+ *
+ * minimize searches for the smallest k from k downwards, for at most
+ * time_limit seconds if that is not 0 (see minimize.h)
+ */
 typedef struct {
   char* input_filename;
   char* solution_filename;
   size_t k;
   size_t cutoff;
+  size_t batch;
+  size_t exact;
+  bool greedy;
+  select_type select;
+  bool adaptive;
+  size_t threads;
+  size_t islands;
+  size_t width;
+  char* portfolio[PORTFOLIO_MAX];
+  size_t portfolio_len;
+  uint64_t seed;
+  bool seeded;
+  char* sweep_k;
+  char* sweep_seeds;
+  char* manifest;
+  size_t sweep_threads;
+  bool minimize;
+  double time_limit;
   prob_type type;
   bool save_solution;
 } params;
 
 void init_params(params*);
 bool set_params_from_args(params*,int, char**);
+void set_params_from_string(params* prm, const params* base, const char* options);
+void check_params(const params* prm);
 
 #endif
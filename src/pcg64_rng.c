@@ -36,6 +36,12 @@ size_t pcg64_random_geom(pcg64_random_t *rng, double p)
   return 1 + (int)(log1p(-pcg64_random_unif(rng))/log1p(-p));
 }
 
+/* sample from a geometric distribution, given log1p(-p) */
+size_t pcg64_random_geom_log(pcg64_random_t *rng, double log1mp)
+{
+  return 1 + (int)(log1p(-pcg64_random_unif(rng))/log1mp);
+}
+
 
 /* sample uniformly from {0,1,...,bound-1} */
 uint64_t pcg64_random_bounded(pcg64_random_t *rng, uint64_t bound)
@@ -76,4 +82,44 @@ void pcg64_getentropy(pcg64_random_t* rng)
   pcg64_random_fast(rng);
 }
 
+/* seed rng from a number, for reproducible runs */
+void pcg64_seed(pcg64_random_t* rng, uint64_t seed)
+{
+  rng->inc = PCG_INCREMENT;
+  rng->state = seed + rng->inc;
+  pcg64_random_fast(rng);
+}
+
+/* seed dst from src, with its own increment */
+void pcg64_random_split(pcg64_random_t *dst, pcg64_random_t *src)
+{
+  dst->state = (pcg_ulong_t)pcg64_random_fast(src) << 64 | pcg64_random_fast(src);
+  dst->inc = ((pcg_ulong_t)pcg64_random_fast(src) << 64 | pcg64_random_fast(src)) << 1 | 1;
+  pcg64_random_fast(dst);
+}
 
+/* seed the streams from rng, each with its own increment */
+void pcg64_streams_seed(pcg64_streams_t *streams, pcg64_random_t *rng)
+{
+  int j;
+  for (j=0; j<PCG64_STREAMS; j++){
+    pcg64_random_t* s = &streams->s[j];
+    s->state = (pcg_ulong_t)pcg64_random_fast(rng) << 64 | pcg64_random_fast(rng);
+    s->inc = ((pcg_ulong_t)pcg64_random_fast(rng) << 64 | pcg64_random_fast(rng)) << 1 | 1;
+    pcg64_random_fast(s);
+  }
+}
+
+/* 
+ * fill buf with n random words, taken from the streams in turn (the
+ * streams' generators are independent, so their steps can overlap)
+ */
+void pcg64_streams_fill(pcg64_streams_t *streams, uint64_t buf[], size_t n)
+{
+  size_t i;
+  int j;
+  for (i=0; i+PCG64_STREAMS <= n; i+=PCG64_STREAMS){
+    for (j=0; j<PCG64_STREAMS; j++) buf[i+j] = pcg64_random_fast(&streams->s[j]);
+  }
+  for (j=0; i<n; i++,j++) buf[i] = pcg64_random_fast(&streams->s[j]);
+}
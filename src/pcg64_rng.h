@@ -2,6 +2,7 @@
 #define PCG64_RNG_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define PCG_INCREMENT    ((pcg_ulong_t)6364136223846793005ULL << 64 |\
                           (pcg_ulong_t)1442695040888963407ULL)
@@ -10,11 +11,20 @@
 
 typedef struct { pcg_ulong_t state, inc; } pcg64_random_t;
 
+/* Independent generators drawn from in turn, for bulk generation */
+#define PCG64_STREAMS 4
+typedef struct { pcg64_random_t s[PCG64_STREAMS]; } pcg64_streams_t;
+
 uint64_t pcg64_random_fast(pcg64_random_t *rng);
 double pcg64_random_unif(pcg64_random_t *rng);
 uint64_t pcg64_random_geom(pcg64_random_t *rng, double p);
+uint64_t pcg64_random_geom_log(pcg64_random_t *rng, double log1mp);
 uint64_t pcg64_random_bounded(pcg64_random_t *rng, uint64_t bound);
 void pcg64_random_choose2(pcg64_random_t *rng, uint64_t elements[], uint64_t bound);
 void pcg64_getentropy(pcg64_random_t* rng);
+void pcg64_seed(pcg64_random_t* rng, uint64_t seed);
+void pcg64_random_split(pcg64_random_t *dst, pcg64_random_t *src);
+void pcg64_streams_seed(pcg64_streams_t *streams, pcg64_random_t *rng);
+void pcg64_streams_fill(pcg64_streams_t *streams, uint64_t buf[], size_t n);
 
 #endif
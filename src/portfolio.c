@@ -0,0 +1,40 @@
+#include <stdlib.h>
+
+#include "graph.h"
+#include "params.h"
+#include "context.h"
+#include "run.h"
+#include "race.h"
+#include "portfolio.h"
+
+/* Read and check the settings of the portfolio configurations of base */
+void portfolio_init(portfolio* pf, const params* base)
+{
+  int i;
+  pf->count = base->portfolio_len;
+  pf->prm = malloc(pf->count*sizeof(params));
+  for (i=0; i<pf->count; i++){
+    set_params_from_string(&pf->prm[i],base,base->portfolio[i]);
+    check_params(&pf->prm[i]);
+  }
+}
+
+/* Create a run for each configuration on G */
+void portfolio_start(portfolio* pf, const graph_data* G)
+{
+  race* r = &pf->r;
+  int i;
+  race_init(r,pf->count);
+  for (i=0; i<pf->count; i++){
+    run_init(&r->rs[i],G,&pf->prm[i],i);
+    context_parallel(r->rs[i].ctx,pf->prm[i].threads);
+    run_connect(&r->rs[i],&r->stop,NULL,NULL);
+  }
+}
+
+/* Free the portfolio */
+void portfolio_free(portfolio* pf)
+{
+  race_free(&pf->r);
+  free(pf->prm);
+}
@@ -0,0 +1,35 @@
+/*
+ * Portfolio: a race of runs with different solver settings on one
+ * shared (read-only) graph, cancelled as soon as one of them is solved
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <stdlib.h>
+
+#include "graph.h"
+#include "params.h"
+#include "run.h"
+#include "race.h"
+
+/*
+ * configuration i has the settings prm[i] and runs as r.rs[i]; count
+ * is the number of configurations
+ */
+typedef struct {
+  race r;
+  params* prm;
+  int count;
+} portfolio;
+
+/* Read and check the settings of the portfolio configurations of base */
+void portfolio_init(portfolio* pf, const params* base);
+
+/* Create a run for each configuration on G */
+void portfolio_start(portfolio* pf, const graph_data* G);
+
+/* Free the portfolio */
+void portfolio_free(portfolio* pf);
+
+#endif
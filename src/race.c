@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <assert.h>
+
+#include "run.h"
+#include "race.h"
+
+struct race_arg {
+  race* r;
+  int i;
+};
+
+/*
+ * Allocate a race of count runs, including the arguments of their
+ * threads, so that starting a run does not allocate while the runs
+ * started before it are already looping
+ */
+void race_init(race* r, int count)
+{
+  int i;
+  assert(count >= 1 && count <= RACE_MAX);
+  r->count = count;
+  r->rs = malloc(count*sizeof(run_state));
+  r->tid = malloc(count*sizeof(pthread_t));
+  r->arg = malloc(count*sizeof(struct race_arg));
+  for (i=0; i<count; i++){
+    r->arg[i].r = r;
+    r->arg[i].i = i;
+  }
+  r->seconds = calloc(count,sizeof(double));
+  atomic_init(&r->winner,-1);
+  atomic_init(&r->stop,false);
+}
+
+/* Free the race and its runs */
+void race_free(race* r)
+{
+  int i;
+  for (i=0; i<r->count; i++) run_free(&r->rs[i]);
+  free(r->rs);
+  free(r->tid);
+  free(r->arg);
+  free(r->seconds);
+}
+
+/* Seconds on the monotonic clock */
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+/* Run one run, and stop the others if it was solved first */
+static void* race_main(void* p)
+{
+  struct race_arg* a = p;
+  race* r = a->r;
+  int i = a->i, none = -1;
+  double start = now();
+
+  run_solve(&r->rs[i]);
+  r->seconds[i] = now() - start;
+  if (r->rs[i].solved && atomic_compare_exchange_strong(&r->winner,&none,i)){
+    atomic_store(&r->stop,true);
+  }
+  return NULL;
+}
+
+/* Run every run on its own thread until one is solved or all reach their cutoff */
+void race_run(race* r)
+{
+  int i;
+  for (i=0; i<r->count; i++) pthread_create(&r->tid[i],NULL,race_main,&r->arg[i]);
+  for (i=0; i<r->count; i++) pthread_join(r->tid[i],NULL);
+}
+
+/* The run that was solved, otherwise the one with the smallest population */
+int race_best(race* r)
+{
+  int i, best = atomic_load(&r->winner);
+  if (best >= 0) return best;
+  best = 0;
+  for (i=1; i<r->count; i++){
+    if (r->rs[i].popsize < r->rs[best].popsize) best = i;
+  }
+  return best;
+}
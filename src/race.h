@@ -0,0 +1,52 @@
+/*
+ * Race of runs on the same graph, each on its own thread with its own
+ * context, all of them stopping as soon as one is solved (the islands
+ * of an island model, or the configurations of a portfolio)
+ */
+
+#ifndef RACE_H
+#define RACE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "run.h"
+
+/* Largest number of runs in a race */
+#define RACE_MAX 64
+
+/* Arguments of a run thread */
+struct race_arg;
+
+/*
+ * rs[0..count-1] are the runs (initialized by the caller with run_init
+ * and joined with run_connect to stop), arg[i] the arguments of the
+ * thread of run i, seconds[i] the wall clock time run i ran, winner the
+ * first run to be solved (-1 while none is), and stop is set once one
+ * is
+ */
+typedef struct {
+  int count;
+  run_state* rs;
+  pthread_t* tid;
+  struct race_arg* arg;
+  double* seconds;
+  atomic_int winner;
+  atomic_bool stop;
+} race;
+
+/* Allocate a race of count runs */
+void race_init(race* r, int count);
+
+/* Free the race and its runs */
+void race_free(race* r);
+
+/* Run every run on its own thread until one is solved or all reach their cutoff */
+void race_run(race* r);
+
+/* The run that was solved, otherwise the one with the smallest population */
+int race_best(race* r);
+
+#endif
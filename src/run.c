@@ -0,0 +1,749 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+
+#include "pcg64_rng.h"
+#include "graph.h"
+#include "chromosome.h"
+#include "cvd.h"
+#include "cd.h"
+#include "cep.h"
+#include "fpt.h"
+#include "params.h"
+#include "ttable.h"
+#include "bitslice.h"
+#include "alloc_debug.h"
+#include "context.h"
+#include "migration.h"
+#include "run.h"
+
+/* 
+ * Sample the positions flipped by standard uniform mutation of a set
+ * with the given capacity; returns the number of positions
+ */
+size_t mutation_positions(context* ctx, size_t capacity, double rate, int* flips)
+{
+  size_t len = 0;
+  double log1mrate = log1p(-rate);
+  size_t i = pcg64_random_geom_log(&ctx->rng,log1mrate) - 1;
+  while (i < capacity){
+    flips[len++] = i;
+    i += pcg64_random_geom_log(&ctx->rng,log1mrate);
+  }    
+  return len;
+}
+
+/* 
+ * Standard uniform mutation, performed in place. The flipped
+ * positions are logged in flips so that the mutation can be undone;
+ * returns the number of flipped positions.
+ */
+size_t mutate(context* ctx, chromosome* chr, double rate, int* flips)
+{
+  size_t i, len = mutation_positions(ctx,chr->S.capacity,rate,flips);
+  for (i=0; i<len; i++) chromosome_flip(chr,flips[i]);
+  return len;
+}
+
+/* Flip the logged positions of chr->S (undoes a mutation) */
+void flip_logged(chromosome* chr, const int* flips, size_t len)
+{
+  size_t i;
+  for (i=0; i<len; i++) chromosome_flip(chr,flips[i]);
+}
+
+/* Next buffered random word of ctx, refilling the buffer from the streams when used up */
+static inline word random_word(context* ctx)
+{
+  if (ctx->rbits_pos == ctx->rbits_len){
+    pcg64_streams_fill(&ctx->streams,ctx->rbits,ctx->rbits_len);
+    ctx->rbits_pos = 0;
+  }
+  return ctx->rbits[ctx->rbits_pos++];
+}
+
+/* 
+ * Uniform 3-way crossover, a word at a time: two random bits per
+ * element select p1 (00), p2 (01) or p3 (10), and elements drawing 11
+ * draw again. All random words, redraws included, come from the bulk
+ * buffer of ctx.
+ */
+void crossover(context* ctx, packed_set* x, const packed_set* p1, const packed_set* p2, const packed_set* p3)
+{
+  size_t i;
+  assert(x->capacity == p1->capacity && p1->capacity == p2->capacity);
+  for (i=0; i<x->word_cnt; i++){
+    word a = random_word(ctx);
+    word b = random_word(ctx);
+    word pending = a & b;
+    word y = (~a & ~b & p1->data[i]) | (~a & b & p2->data[i]) | (a & ~b & p3->data[i]);
+    while (pending){
+      a = random_word(ctx);
+      b = random_word(ctx);
+      y |= pending & ((~a & ~b & p1->data[i]) | (~a & b & p2->data[i]) | (a & ~b & p3->data[i]));
+      pending &= a & b;
+    }
+    x->data[i] = y;
+  }
+}
+
+/* Select two distinct elements of [0,n) */
+void select2(context* ctx, int* a, int* b, int n)
+{
+  assert(n > 1);
+  if (n == 2){
+    *a = pcg64_random_fast(&ctx->rng) % 2;
+    *b = 1 - *a;
+  }
+  else {
+    *a = pcg64_random_bounded(&ctx->rng,n);
+    do {
+      *b = pcg64_random_bounded(&ctx->rng,n);
+    } while (*a == *b);
+  }
+}
+  
+/* 
+ * Solve the connected components of G with at most exact vertices
+ * exactly, merging the chromosomes seeded with their vertices into
+ * one that carries the solution (components without a solution within
+ * the budget are left as they are). Returns the number of components
+ * solved.
+ */
+static size_t presolve_components(run_state* rs, size_t exact)
+{
+  const graph_data* G = rs->ctx->G;
+  int* comp = malloc(G->n*sizeof(int));
+  int* queue = malloc(G->n*sizeof(int));
+  bool* merged = calloc(G->n,sizeof(bool));
+  size_t solved = 0, live = 0;
+  int i, j, head, tail;
+
+  for (i=0; i<G->n; i++) comp[i] = -1;
+  for (i=0; i<G->n; i++){
+    chromosome* chr = rs->P[i];
+    if (comp[i] >= 0) continue;
+
+    /* breadth-first search from i, the first vertex of its component */
+    comp[i] = i;
+    queue[0] = i;
+    for (head=0,tail=1; head<tail; head++){
+      int v = queue[head];
+      for (j=0; j<G->adj_list_len[v]; j++){
+	int u = G->adj_list[v][j];
+	if (comp[u] < 0){
+	  comp[u] = i;
+	  queue[tail++] = u;
+	}
+      }
+    }
+    if (tail < 2 || (size_t)tail > exact) continue;
+
+    /* P[i] is still the chromosome seeded with i: grow it to the component */
+    for (j=1; j<tail; j++) ps_store(&chr->V,queue[j]);
+    chromosome_update_cache(chr,G);
+    if (fpt_solve(chr,rs->ctx->k,rs->ctx) >= 0){
+      for (j=1; j<tail; j++) merged[queue[j]] = true;
+      solved++;
+    }
+    else chromosome_seed(chr,i);
+  }
+
+  /* move the chromosomes merged away behind the population */
+  for (i=0; i<G->n; i++){
+    if (!merged[i]){
+      chromosome* tmp = rs->P[live];
+      rs->P[live++] = rs->P[i];
+      rs->P[i] = tmp;
+    }
+  }
+  rs->popsize = live;
+
+  free(comp);
+  free(queue);
+  free(merged);
+  return solved;
+}
+
+/* 
+ * Seed chr, whose V is {v}, with the elements of the greedy solution H
+ * at v: v itself for CVD, otherwise the edges (and for CEP the indexed
+ * non-edges) of H incident to v, so that merging two chromosomes
+ * brings in H on the edges between them
+ */
+static void seed_greedy(chromosome* chr, int v, const packed_set* H, const context* ctx)
+{
+  const graph_data* G = ctx->G;
+  int j;
+  if (ctx->type == CVD){
+    if (ps_read(H,v)) ps_store(&chr->S,v);
+    return;
+  }
+  for (j=0; j<G->adj_list_len[v]; j++){
+    if (ps_read(H,G->adj_elist[v][j])) ps_store(&chr->S,G->adj_elist[v][j]);
+  }
+  for (j=0; ctx->type == CEP && j<G->nadj_list_len[v]; j++){
+    if (ps_read(H,G->m+G->nadj_elist[v][j])) ps_store(&chr->S,G->m+G->nadj_elist[v][j]);
+  }
+}
+
+/* Name of a selection scheme */
+const char* select_name(select_type select)
+{
+  return (select == SELECT_ADJACENT) ? "adjacent" : "uniform";
+}
+
+/* Add edge e to the edges between chromosomes */
+static void cut_add(run_state* rs, int e)
+{
+  rs->cut_pos[e] = rs->cut_len;
+  rs->cut[rs->cut_len++] = e;
+}
+
+/* Remove edge e from the edges between chromosomes */
+static void cut_remove(run_state* rs, int e)
+{
+  int last = rs->cut[--rs->cut_len];
+  rs->cut[rs->cut_pos[e]] = last;
+  rs->cut_pos[last] = rs->cut_pos[e];
+  rs->cut_pos[e] = -1;
+}
+
+/* Index the owners of the vertices and the edges between chromosomes */
+static void owners_init(run_state* rs)
+{
+  const graph_data* G = rs->ctx->G;
+  size_t i;
+  int j;
+
+  for (i=0; i<rs->popsize; i++){
+    for (j=0; j<rs->P[i]->cached_Vlist_len; j++) rs->owner[rs->P[i]->cached_Vlist[j]] = i;
+  }
+  rs->cut_len = 0;
+  for (j=0; j<G->m; j++){
+    rs->cut_pos[j] = -1;
+    if (rs->owner[src(G->edge_list[j])] != rs->owner[snk(G->edge_list[j])]) cut_add(rs,j);
+  }
+}
+
+/* Relabel the vertices of chr as owned by P[i] */
+static void owners_relabel(run_state* rs, const chromosome* chr, int i)
+{
+  int j;
+  for (j=0; j<chr->cached_Vlist_len; j++) rs->owner[chr->cached_Vlist[j]] = i;
+}
+
+/*
+ * Update the owners before the offspring of P[a] and P[b] replaces
+ * them, P[last] being the last member of the population: the edges
+ * between the parents leave the cut (found from the smaller one), and
+ * the offspring ends up at a unless last is a, in which case it ends
+ * up at b and nothing else moves; otherwise P[last] moves to b.
+ */
+static void owners_merge(run_state* rs, int a, int b, int last)
+{
+  const graph_data* G = rs->ctx->G;
+  const chromosome* small = rs->P[a];
+  int other = b;
+  int dest = (last == a) ? b : a;
+  int i, j;
+
+  if (rs->P[b]->cached_Vlist_len < small->cached_Vlist_len){
+    small = rs->P[b];
+    other = a;
+  }
+  for (i=0; i<small->cached_Vlist_len; i++){
+    int v = small->cached_Vlist[i];
+    for (j=0; j<G->adj_list_len[v]; j++){
+      if (rs->owner[G->adj_list[v][j]] == other) cut_remove(rs,G->adj_elist[v][j]);
+    }
+  }
+  owners_relabel(rs,rs->P[dest == a ? b : a],dest);
+  if (last != a && last != b) owners_relabel(rs,rs->P[last],b);
+}
+
+/*
+ * Choose the crossover partners as the owners of a random edge
+ * between two chromosomes (keeping the uniform choice if there is
+ * none, e.g. once only components remain)
+ */
+static void select_adjacent(run_state* rs, uint64_t* parent)
+{
+  const graph_data* G = rs->ctx->G;
+  int e;
+  if (rs->cut_len == 0) return;
+  e = rs->cut[pcg64_random_bounded(&rs->ctx->rng,rs->cut_len)];
+  parent[0] = rs->owner[src(G->edge_list[e])];
+  parent[1] = rs->owner[snk(G->edge_list[e])];
+}
+
+/*
+ * Adjust the operator probabilities at the end of a window: crossover
+ * gets the share of the (smoothed) success rates of the two
+ * operators, and the mutation rate grows while more than a fifth of
+ * the mutants succeed and shrinks otherwise. A crossover succeeds if
+ * its offspring is accepted, but a mutant only if it is smaller than
+ * its parent (mutants of equal size are kept too, but with these
+ * counted as successes mutation would crowd out crossover whenever
+ * the last merges are hard). Logs the new values.
+ */
+static void adapt(run_state* rs, size_t t)
+{
+  size_t setlen = rs->ctx->setlen;
+  size_t xtries = rs->crossovers - rs->window_start[0];
+  size_t xacc = rs->accepted - rs->window_start[1];
+  size_t mtries = rs->mutations - rs->window_start[2];
+  size_t macc = rs->improved - rs->window_start[3];
+  double xs = (xacc + 1.0)/(xtries + 2.0);
+  double ms = (macc + 1.0)/(mtries + 2.0);
+
+  /* without any success, drift back to the static setting */
+  if (xacc + macc > 0){
+    rs->pcross = xs/(xs + ms);
+    if (rs->pcross < ADAPT_PCROSS_MIN) rs->pcross = ADAPT_PCROSS_MIN;
+    if (rs->pcross > ADAPT_PCROSS_MAX) rs->pcross = ADAPT_PCROSS_MAX;
+  }
+  else rs->pcross = (rs->pcross + PCROSS)/2;
+  if (mtries > 0) rs->mrate *= (5*macc > mtries) ? 1.25 : 0.8;
+  if (rs->mrate*setlen < ADAPT_MRATE_MIN) rs->mrate = ADAPT_MRATE_MIN/setlen;
+  if (rs->mrate*setlen > ADAPT_MRATE_MAX) rs->mrate = ADAPT_MRATE_MAX/setlen;
+
+  fprintf(stderr,"adapt: t=%lu crossover %lu/%lu mutation %lu/%lu -> pcross=%.3f mrate=%.2f/%lu\n",
+	  t,xacc,xtries,macc,mtries,rs->pcross,rs->mrate*setlen,setlen);
+  rs->window_start[0] = rs->crossovers;
+  rs->window_start[1] = rs->accepted;
+  rs->window_start[2] = rs->mutations;
+  rs->window_start[3] = rs->improved;
+}
+
+static int merge(run_state* rs, chromosome* dest, const chromosome* a, const chromosome* b);
+
+/*
+ * Take in the migrant (in rs->migrant) if that does not grow the
+ * population. The migrant X absorbs the chromosomes it touches: those
+ * whose V lies inside X.V are dropped, and each of the others is
+ * merged into X by crossover and repair, as in a generation. X is
+ * turned away unless it absorbed at least one of them; otherwise X.V
+ * is cut out of the V of those that could not be merged, which keeps
+ * them feasible, and X takes the slot of a dropped one.
+ */
+static bool immigrate(run_state* rs)
+{
+  const graph_data* G = rs->ctx->G;
+  chromosome** P = rs->P;
+  chromosome* tmp;
+  size_t i, absorbed = 0;
+
+  for (i=0; i<rs->popsize; i++){
+    size_t common = ps_popcount_and(&P[i]->V,&rs->migrant->V);
+    if (common == 0) continue;
+    if (common == (size_t)P[i]->cached_Vlist_len) absorbed++;
+    else if (merge(rs,rs->offspr,rs->migrant,P[i]) >= 0){
+      tmp = rs->migrant;
+      rs->migrant = rs->offspr;
+      rs->offspr = tmp;
+      absorbed++;
+    }
+  }
+  if (absorbed == 0) return false;
+
+  /* the merged chromosomes now lie inside X.V as well */
+  i = 0;
+  while (i < rs->popsize){
+    size_t common = ps_popcount_and(&P[i]->V,&rs->migrant->V);
+    if (common == (size_t)P[i]->cached_Vlist_len){
+      tmp = P[i];
+      P[i] = P[rs->popsize-1];
+      P[--rs->popsize] = tmp;
+      continue;
+    }
+    if (common > 0){
+      ps_subtract(&P[i]->V,&rs->migrant->V);
+      chromosome_update_cache(P[i],G);
+    }
+    i++;
+  }
+  chromosome_copy(P[rs->popsize++],rs->migrant);
+  if (rs->select == SELECT_ADJACENT) owners_init(rs);
+  rs->immigrants++;
+  return true;
+}
+
+/*
+ * Migration: send a copy of the largest chromosome to the next island
+ * and take in the migrants from the previous one
+ */
+static void migrate(run_state* rs)
+{
+  size_t i, largest = 0;
+  for (i=1; i<rs->popsize; i++){
+    if (rs->P[i]->cached_Vlist_len > rs->P[largest]->cached_Vlist_len) largest = i;
+  }
+  mq_push(rs->outbox,rs->P[largest]);
+  while (mq_pop(rs->inbox,rs->migrant)) immigrate(rs);
+}
+
+/*
+ * Create the initial population for the problem on G set by prm, with
+ * the stream-th generator split off the seed (0 for a single run)
+ */
+void run_init(run_state* rs, const graph_data* G, const params* prm, int stream)
+{
+  prob_type type = prm->type;
+  size_t batch = prm->batch;
+  size_t exact = prm->exact;
+  bool greedy = prm->greedy;
+  int i;
+  size_t setlen;
+  packed_set H;
+
+  /* create operator context (this seeds its random number generator) */
+  rs->ctx = context_create(G,type,prm->k);
+  if (prm->seeded){
+    pcg64_random_t seed;
+    pcg64_seed(&seed,prm->seed);
+    context_seed(rs->ctx,&seed);
+  }
+  if (stream > 0) context_stream(rs->ctx,stream);
+  setlen = rs->ctx->setlen;
+
+  /* greedy solution of the whole graph, if seeding from one */
+  rs->greedy = -1;
+  if (greedy){
+    ps_init(&H,setlen);
+    if (type == CVD) cvd_greedy(&H,G);
+    if (type == CD) cd_greedy(&H,G);
+    if (type == CEP) cep_greedy(&H,G);
+    rs->greedy = ps_popcount(&H);
+  }
+
+  rs->popsize = G->n;
+  rs->P = malloc(rs->popsize*sizeof(chromosome*));
+  for (i=0; i<G->n; i++){
+    rs->P[i] = malloc(sizeof(chromosome));
+    chromosome_init(rs->P[i],setlen,G);
+    chromosome_seed(rs->P[i],i);
+    if (greedy) seed_greedy(rs->P[i],i,&H,rs->ctx);
+    else ps_randomize(&rs->P[i]->S,&rs->ctx->rng);
+    chromosome_rehash(rs->P[i]);
+    chromosome_invalidate(rs->P[i]);
+  }
+  if (greedy) ps_free(&H);
+  rs->offspr = malloc(sizeof(chromosome));
+  chromosome_init(rs->offspr,setlen,G);
+  ps_init(&rs->tau,setlen);
+  rs->flips = malloc(batch*setlen*sizeof(int));
+  tt_init(&rs->tt,TT_LOG2SIZE);
+  if (batch > 1) bs_init(&rs->bs,type,G);
+  rs->batch = batch;
+  rs->exact = exact;
+  rs->presolved = (exact > 1) ? presolve_components(rs,exact) : 0;
+  rs->select = prm->select;
+  if (rs->select == SELECT_ADJACENT){
+    rs->owner = malloc(G->n*sizeof(int));
+    rs->cut = malloc((G->m+1)*sizeof(int));
+    rs->cut_pos = malloc((G->m+1)*sizeof(int));
+    owners_init(rs);
+  }
+  rs->crossovers = rs->accepted = 0;
+  rs->mutations = rs->kept = rs->improved = 0;
+  rs->pcross = PCROSS;
+  rs->mrate = 1.0/setlen;
+  rs->adaptive = prm->adaptive;
+  for (i=0; i<4; i++) rs->window_start[i] = 0;
+  rs->width = prm->width;
+  rs->slot = NULL;
+  rs->discarded = 0;
+  if (rs->width > 1){
+    rs->slot = malloc(rs->width*sizeof(spec_slot));
+    for (i=0; i<(int)rs->width; i++){
+      spec_slot* sl = &rs->slot[i];
+      sl->ctx = context_create(G,type,prm->k);
+      context_seed(sl->ctx,&rs->ctx->rng);
+      sl->offspr = malloc(sizeof(chromosome));
+      chromosome_init(sl->offspr,setlen,G);
+      ps_init(&sl->tau,setlen);
+      sl->flips = malloc(setlen*sizeof(int));
+      tt_init(&sl->tt,TT_LOG2SIZE);
+    }
+  }
+  rs->inbox = rs->outbox = NULL;
+  rs->stop = NULL;
+  rs->migrant = NULL;
+  rs->immigrants = 0;
+  rs->cutoff = prm->cutoff;
+  rs->t = 0;
+  rs->solved = false;
+}
+
+/* Free the population and scratch space */
+void run_free(run_state* rs)
+{
+  int i;
+  for (i=0; i<rs->ctx->G->n; i++){
+    chromosome_free(rs->P[i]);
+    free(rs->P[i]);
+  }
+  free(rs->P);
+  chromosome_free(rs->offspr);
+  free(rs->offspr);
+  ps_free(&rs->tau);
+  free(rs->flips);
+  tt_free(&rs->tt);
+  if (rs->batch > 1) bs_free(&rs->bs);
+  if (rs->select == SELECT_ADJACENT){
+    free(rs->owner);
+    free(rs->cut);
+    free(rs->cut_pos);
+  }
+  if (rs->migrant){
+    chromosome_free(rs->migrant);
+    free(rs->migrant);
+  }
+  if (rs->slot){
+    for (i=0; i<(int)rs->width; i++){
+      spec_slot* sl = &rs->slot[i];
+      context_destroy(sl->ctx);
+      chromosome_free(sl->offspr);
+      free(sl->offspr);
+      ps_free(&sl->tau);
+      free(sl->flips);
+      tt_free(&sl->tt);
+    }
+    free(rs->slot);
+  }
+  context_destroy(rs->ctx);
+}
+
+/* Add the statistics of the context ctx to wc and fs */
+static void add_statistics(const context* ctx, witness_cache* wc, fpt_stats* fs)
+{
+  const witness_cache* w = NULL;
+  const fpt_stats* f;
+  if (ctx->type == CVD) w = cvd_witnesses(ctx);
+  if (ctx->type == CD) w = cd_witnesses(ctx);
+  if (w){
+    wc->lookups += w->lookups;
+    wc->rejections += w->rejections;
+    wc->hits += w->hits;
+  }
+  if (ctx->fpt){
+    f = fpt_statistics(ctx);
+    fs->calls += f->calls;
+    fs->solved += f->solved;
+    fs->aborted += f->aborted;
+    fs->nodes += f->nodes;
+  }
+}
+
+/*
+ * Statistics of the transposition tables, witness caches (CVD and CD)
+ * and exact solver, summed over the contexts of the run
+ */
+void run_statistics(const run_state* rs, size_t* tt_lookups, size_t* tt_hits, witness_cache* wc, fpt_stats* fs)
+{
+  size_t i;
+  *tt_lookups = rs->tt.lookups;
+  *tt_hits = rs->tt.hits;
+  wc->lookups = wc->rejections = wc->hits = 0;
+  memset(fs,0,sizeof(fpt_stats));
+  add_statistics(rs->ctx,wc,fs);
+  for (i=0; rs->slot && i<rs->width; i++){
+    *tt_lookups += rs->slot[i].tt.lookups;
+    *tt_hits += rs->slot[i].tt.hits;
+    add_statistics(rs->slot[i].ctx,wc,fs);
+  }
+}
+
+/*
+ * Make the run stop once *stop is set and, if inbox is not NULL, an
+ * island of a ring: it receives migrants from inbox and sends them to
+ * outbox
+ */
+void run_connect(run_state* rs, atomic_bool* stop, migration_queue* inbox, migration_queue* outbox)
+{
+  rs->stop = stop;
+  rs->inbox = inbox;
+  rs->outbox = outbox;
+  if (inbox){
+    rs->migrant = malloc(sizeof(chromosome));
+    chromosome_init(rs->migrant,rs->ctx->setlen,rs->ctx->G);
+  }
+}
+
+#define RUN_SOLVE run_solve_cvd
+#define RUN_SPECULATE run_speculate_cvd
+#define RUN_SLOTS run_slots_cvd
+#define RUN_CALCULATE calculate_cvd
+#define RUN_FEASIBLE cvd_feasible
+#define RUN_REPAIR cvd_repair
+#define RUN_TEMPLATE cvd_template
+#define RUN_MUTANT_FITNESS cvd_mutant_fitness
+#include "run_template.h"
+
+#define RUN_SOLVE run_solve_cd
+#define RUN_SPECULATE run_speculate_cd
+#define RUN_SLOTS run_slots_cd
+#define RUN_CALCULATE calculate_cd
+#define RUN_FEASIBLE cd_feasible
+#define RUN_REPAIR cd_repair
+#define RUN_TEMPLATE cd_template
+#define RUN_MUTANT_FITNESS cd_mutant_fitness
+#include "run_template.h"
+
+#define RUN_SOLVE run_solve_cep
+#define RUN_SPECULATE run_speculate_cep
+#define RUN_SLOTS run_slots_cep
+#define RUN_CALCULATE calculate_cep
+#define RUN_FEASIBLE cep_feasible
+#define RUN_REPAIR cep_repair
+#define RUN_TEMPLATE cep_template
+/* no RUN_MUTANT_FITNESS: an edit can join or split clusters far from it */
+#include "run_template.h"
+
+/* Fitness of chr under the budget of ctx */
+static int calculate(chromosome* chr, context* ctx)
+{
+  if (ctx->type == CVD) return calculate_cvd(chr,ctx);
+  if (ctx->type == CD) return calculate_cd(chr,ctx);
+  return calculate_cep(chr,ctx);
+}
+
+/*
+ * Build in dest the offspring of a and b by crossover and repair, and
+ * return its fitness. Unlike the parents in a generation, a and b may
+ * share vertices, so the repaired offspring is always checked in full.
+ */
+static int merge(run_state* rs, chromosome* dest, const chromosome* a, const chromosome* b)
+{
+  context* ctx = rs->ctx;
+  chromosome_vmerge(dest,a,b,ctx->G);
+  if (ctx->type == CVD) cvd_template(&rs->tau,dest,a,b,ctx);
+  if (ctx->type == CD) cd_template(&rs->tau,dest,a,b,ctx);
+  if (ctx->type == CEP) cep_template(&rs->tau,dest,a,b,ctx);
+  crossover(ctx,&dest->S,&a->S,&b->S,&rs->tau);
+  chromosome_rehash(dest);
+  if (ctx->type == CVD) cvd_repair(dest,&a->S,&b->S,&rs->tau,ctx);
+  if (ctx->type == CD) cd_repair(dest,&a->S,&b->S,&rs->tau,ctx);
+  if (ctx->type == CEP) cep_repair(dest,&a->S,&b->S,&rs->tau,ctx);
+  chromosome_invalidate(dest);
+  return calculate(dest,ctx);
+}
+
+/*
+ * Change the budget of the run; the transposition tables are emptied,
+ * as the fitness they recorded depends on it
+ */
+void run_set_budget(run_state* rs, int k)
+{
+  size_t i;
+  rs->ctx->k = k;
+  tt_clear(&rs->tt);
+  for (i=0; rs->slot && i<rs->width; i++){
+    rs->slot[i].ctx->k = k;
+    tt_clear(&rs->slot[i].tt);
+  }
+}
+
+/*
+ * Split a solved population back into the clusters of its solution S
+ * (the components of G edited by S, with each vertex deleted by CVD on
+ * its own), every one keeping S, so that the run can continue from
+ * there under a smaller budget. A cluster that no longer fits the
+ * budget is split into single vertices with empty solution sets.
+ */
+void run_resplit(run_state* rs)
+{
+  context* ctx = rs->ctx;
+  const graph_data* G = ctx->G;
+  chromosome** P = rs->P;
+  int* comp = malloc(G->n*sizeof(int));
+  int* queue = malloc(G->n*sizeof(int));
+  packed_set S;
+  int v, j, c, len, parts = 0;
+
+  assert(rs->popsize == 1);
+  ps_copyinit(&S,&P[0]->S);
+
+  /* label the clusters by breadth-first search over the edited graph */
+  for (v=0; v<G->n; v++) comp[v] = -1;
+  for (v=0; v<G->n; v++){
+    int head = 0, tail = 0;
+    bool deleted = (ctx->type == CVD && ps_read(&S,v));
+    if (comp[v] >= 0) continue;
+    comp[v] = parts;
+    queue[tail++] = v;
+    while (!deleted && head < tail){
+      int x = queue[head++];
+      for (j=0; j<G->adj_list_len[x]; j++){
+	int y = G->adj_list[x][j];
+	bool kept = (ctx->type == CVD) ? !ps_read(&S,y) : !ps_read(&S,G->adj_elist[x][j]);
+	if (kept && comp[y] < 0){
+	  comp[y] = parts;
+	  queue[tail++] = y;
+	}
+      }
+      for (j=0; ctx->type == CEP && j<G->nadj_list_len[x]; j++){
+	int y = G->nadj_list[x][j];
+	if (ps_read(&S,G->m + G->nadj_elist[x][j]) && comp[y] < 0){
+	  comp[y] = parts;
+	  queue[tail++] = y;
+	}
+      }
+    }
+    parts++;
+  }
+
+  /* one chromosome per cluster, keeping S (but not a deleted vertex) */
+  for (c=0; c<parts; c++) ps_zero(&P[c]->V);
+  for (v=0; v<G->n; v++) ps_store(&P[comp[v]]->V,v);
+  for (c=0; c<parts; c++){
+    ps_copy(&P[c]->S,&S);
+    chromosome_update_cache(P[c],G);
+    if (ctx->type == CVD && P[c]->cached_Vlist_len == 1) ps_clear(&P[c]->S,P[c]->cached_Vlist[0]);
+    chromosome_rehash(P[c]);
+  }
+
+  /* clusters over the budget fall apart into single vertices */
+  for (c=0, len=parts; c<len; c++){
+    if (calculate(P[c],ctx) >= 0) continue;
+    memcpy(queue,P[c]->cached_Vlist,P[c]->cached_Vlist_len*sizeof(int));
+    for (j=P[c]->cached_Vlist_len-1; j>=0; j--){
+      chromosome* chr = (j == 0) ? P[c] : P[parts++];
+      chromosome_seed(chr,queue[j]);
+      ps_zero(&chr->S);
+      chromosome_rehash(chr);
+    }
+  }
+
+  rs->popsize = parts;
+  rs->solved = false;
+  if (rs->select == SELECT_ADJACENT) owners_init(rs);
+  ps_free(&S);
+  free(comp);
+  free(queue);
+}
+
+/* Run the generation loop specialized for the problem type */
+void run_solve(run_state* rs)
+{
+  switch (rs->ctx->type){
+  case CVD:
+    if (rs->width > 1) run_speculate_cvd(rs);
+    else run_solve_cvd(rs);
+    break;
+  case CD:
+    if (rs->width > 1) run_speculate_cd(rs);
+    else run_solve_cd(rs);
+    break;
+  case CEP:
+    if (rs->width > 1) run_speculate_cep(rs);
+    else run_solve_cep(rs);
+    break;
+  default:
+    assert(false);
+  }
+}
@@ -0,0 +1,186 @@
+/*
+ * State of a SubPopGA run: the population and everything the
+ * generation loop needs besides the operator context
+ */
+
+#ifndef RUN_H
+#define RUN_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "graph.h"
+#include "chromosome.h"
+#include "packed_set.h"
+#include "params.h"
+#include "ttable.h"
+#include "bitslice.h"
+#include "context.h"
+#include "migration.h"
+#include "witness.h"
+#include "fpt.h"
+
+/* log2 of the number of transposition table entries */
+#define TT_LOG2SIZE 16
+
+/* Probability of crossover (otherwise mutation) unless adapted */
+#define PCROSS 0.8
+
+/* 
+ * Adaptation: generations between adjustments, and the range of the
+ * crossover probability and of the mutation rate (times setlen)
+ */
+#define ADAPT_WINDOW 1000
+#define ADAPT_PCROSS_MIN 0.2
+#define ADAPT_PCROSS_MAX 0.95
+#define ADAPT_MRATE_MIN 1.0
+#define ADAPT_MRATE_MAX 16.0
+
+/* Largest number of offspring generated at once */
+#define SPEC_MAX_WIDTH 64
+
+/*
+ * A speculative offspring: the crossover of P[parent[0]] and
+ * P[parent[1]] if cross, otherwise a mutant of P[parent[0]] (whose
+ * fitness is rp), built in offspr with fitness r. Each slot has its
+ * own context (generators and operator scratch), crossover template,
+ * mutation log and transposition table, so that slots can be
+ * evaluated concurrently.
+ */
+typedef struct {
+  context* ctx;
+  chromosome* offspr;
+  packed_set tau;
+  int* flips;
+  ttable tt;
+  uint64_t parent[2];
+  bool cross;
+  bool consumed;
+  int rp;
+  int r;
+} spec_slot;
+
+/*
+ * P[0..popsize-1] is the population (P has room for n chromosomes),
+ * offspr and tau are scratch for crossover and flips the mutation
+ * log (batch*setlen entries). Offspring of at most exact vertices
+ * that the operators could not make feasible are handed to the exact
+ * solver, and presolved counts the components it solved in run_init.
+ * greedy is the size of the greedy solution the population was seeded
+ * from (-1 if it was seeded with random sets).
+ *
+ * With adjacent selection, owner[v] is the index in P of the
+ * chromosome whose V holds v, and cut[0..cut_len-1] lists the edges of
+ * G between two chromosomes (cut_pos[e] is the position of e in cut,
+ * -1 if it is not there); crossover partners are the owners of a
+ * random edge of cut. crossovers counts the offspring evaluated and
+ * accepted those that replaced their parents; mutations counts the
+ * mutants evaluated, kept those that replaced their parent and
+ * improved those that were also smaller.
+ *
+ * pcross is the probability of crossover and mrate the mutation rate.
+ * If adaptive, both are adjusted every ADAPT_WINDOW generations from
+ * the acceptance counts over the window (which start at the counts
+ * in window_start).
+ *
+ * With width > 1, each round draws the parents of width offspring
+ * slot[0..width-1] from the population as it stands, evaluates them
+ * (across the threads of the context's pool) and commits them in
+ * slot order; a slot whose parent was replaced or merged by an
+ * earlier commit of the round is discarded (and counted in
+ * discarded).
+ *
+ * An island of a ring (see run_connect) sends its largest chromosome
+ * to outbox every MIGRATION_INTERVAL generations and takes in those
+ * waiting in inbox (through the scratch chromosome migrant);
+ * immigrants counts the migrants it took in; inbox is NULL for a run
+ * that is not an island. A run in a race (see race.h) stops early
+ * once *stop is set.
+ *
+ * t counts the generations run so far and solved records whether the
+ * population has merged into one.
+ */
+typedef struct {
+  context* ctx;
+  chromosome** P;
+  size_t popsize;
+  chromosome* offspr;
+  packed_set tau;
+  int* flips;
+  ttable tt;
+  bitslice bs;
+  size_t batch;
+  size_t exact;
+  size_t presolved;
+  int greedy;
+  select_type select;
+  int* owner;
+  int* cut;
+  int* cut_pos;
+  int cut_len;
+  size_t crossovers;
+  size_t accepted;
+  size_t mutations;
+  size_t kept;
+  size_t improved;
+  double pcross;
+  double mrate;
+  bool adaptive;
+  size_t window_start[4];
+  size_t width;
+  spec_slot* slot;
+  size_t discarded;
+  migration_queue* inbox;
+  migration_queue* outbox;
+  atomic_bool* stop;
+  chromosome* migrant;
+  size_t immigrants;
+  size_t cutoff;
+  size_t t;
+  bool solved;
+} run_state;
+
+/*
+ * Create the initial population for the problem on G set by prm (type,
+ * budget k, batch, exact, greedy, select, adaptive, width and cutoff), seeding
+ * its solution sets from a greedy solution of G if greedy is set
+ * (otherwise at random). The random number generator is seeded from
+ * prm->seed if set (otherwise from the system's entropy), and is the
+ * stream-th one split off that seed, so that runs sharing a seed draw
+ * independently (stream 0 keeps the seed's own generator).
+ */
+void run_init(run_state* rs, const graph_data* G, const params* prm, int stream);
+
+/*
+ * Make the run stop once *stop is set and, if inbox is not NULL, an
+ * island of a ring: it receives migrants from inbox and sends them to
+ * outbox
+ */
+void run_connect(run_state* rs, atomic_bool* stop, migration_queue* inbox, migration_queue* outbox);
+
+/* Name of a selection scheme */
+const char* select_name(select_type select);
+
+/* Free the population and scratch space */
+void run_free(run_state* rs);
+
+/*
+ * Statistics of the transposition tables, witness caches (CVD and CD)
+ * and exact solver, summed over the contexts of the run
+ */
+void run_statistics(const run_state* rs, size_t* tt_lookups, size_t* tt_hits, witness_cache* wc, fpt_stats* fs);
+
+/* Change the budget of the run (emptying its transposition tables) */
+void run_set_budget(run_state* rs, int k);
+
+/*
+ * Split a solved population back into the clusters of its solution,
+ * to continue under a smaller budget
+ */
+void run_resplit(run_state* rs);
+
+/* Run the generation loop specialized for the problem type */
+void run_solve(run_state* rs);
+
+#endif
@@ -0,0 +1,390 @@
+/*
+ * Generation loop of SubPopGA, instantiated once per problem type by
+ * run.c so that the problem's operators are called directly (and can
+ * be inlined) instead of through function pointers. Define
+ *
+ *   RUN_SOLVE           name of the loop function
+ *   RUN_SPECULATE       name of the speculative loop function
+ *   RUN_SLOTS           name of its slot evaluation function
+ *   RUN_CALCULATE       name of its fitness function
+ *   RUN_FEASIBLE        the problem's operators
+ *   RUN_REPAIR
+ *   RUN_TEMPLATE
+ *   RUN_MUTANT_FITNESS  (optional)
+ *
+ * before including this file; they are undefined at its end. Without
+ * RUN_MUTANT_FITNESS, mutants are checked in full by RUN_CALCULATE.
+ */
+
+#ifndef RUN_MUTANT_FITNESS
+#define RUN_MUTANT_FITNESS(chr,rp,ip,flips,nflips,ctx) ((void)(nflips),RUN_CALCULATE(chr,ctx))
+#endif
+
+/* 
+ * Return how many elements in set, otherwise -1 if not feasible. The
+ * result is cached in chr until it is invalidated.
+ */
+static int RUN_CALCULATE(chromosome* chr, context* ctx)
+{
+  if (chr->fitness == FITNESS_UNKNOWN){
+    chr->fitness = RUN_FEASIBLE(chr,ctx) ? (int)ps_popcount(&chr->S) : FITNESS_INFEASIBLE;
+  }
+  return chr->fitness;
+}
+
+/* Run generations until the population is merged or the cutoff is reached */
+static void RUN_SOLVE(run_state* rs)
+{
+  context* ctx = rs->ctx;
+  const graph_data* G = ctx->G;
+  chromosome** P = rs->P;
+  chromosome* offspr = rs->offspr;
+  int* flips = rs->flips;
+  size_t setlen = ctx->setlen;
+  size_t popsize = rs->popsize;
+  size_t t = rs->t;
+  bool solved = (popsize == 1);
+#ifdef ALLOC_DEBUG
+  size_t allocs;
+#endif
+
+  while( popsize > 1){
+    uint64_t parent[2];
+    uint64_t key;
+    int r;
+#ifdef ALLOC_DEBUG
+    allocs = alloc_count();
+#endif
+
+    /* choose parents */
+    pcg64_random_choose2(&ctx->rng,parent,popsize);
+
+    /* crossover */
+    if (pcg64_random_unif(&ctx->rng) < rs->pcross){
+      /* adjacent selection replaces the partners drawn above */
+      if (rs->select == SELECT_ADJACENT) select_adjacent(rs,parent);
+      rs->crossovers++;
+
+
+      /* offspring vertex set is union of parent vertex sets */
+      chromosome_vmerge(offspr,P[parent[0]],P[parent[1]],G);
+
+      /* compute template parent */
+      RUN_TEMPLATE(&rs->tau,offspr,P[parent[0]],P[parent[1]],ctx);
+
+      /* 3-way uniform crossover */
+      crossover(ctx,&offspr->S,&P[parent[0]]->S,&P[parent[1]]->S,&rs->tau);
+      chromosome_rehash(offspr);
+
+      /* 
+       * the outcome of repair depends on the offspring and the
+       * solution sets of its parents; only rejections can repeat, as
+       * accepting an offspring replaces its parents
+       */
+      key = chromosome_hash(offspr) ^ zobrist_key(chromosome_hash(P[parent[0]]) + chromosome_hash(P[parent[1]]));
+      if (!tt_lookup(&rs->tt,key,&r) || r >= 0){
+	/* repair operator (which may already know the fitness) */
+	r = RUN_REPAIR(offspr,&P[parent[0]]->S,&P[parent[1]]->S,&rs->tau,ctx);
+
+	/* determine feasibility */
+	if (r == FITNESS_UNKNOWN) r = RUN_CALCULATE(offspr,ctx);
+
+	/* endgame: solve small offspring exactly instead */
+	if (r < 0 && (size_t)offspr->cached_Vlist_len <= rs->exact) r = fpt_solve(offspr,ctx->k,ctx);
+	tt_store(&rs->tt,key,r);
+      }
+
+      if (r >= 0) {
+	/* offspring was feasible, it must dominate both parents: swap
+	   it into the population and reuse parent 0 as scratch */
+	chromosome* tmp;
+	rs->accepted++;
+	if (rs->select == SELECT_ADJACENT) owners_merge(rs,parent[0],parent[1],popsize-1);
+	tmp = P[parent[0]];
+	P[parent[0]] = offspr;
+	offspr = tmp;
+	tmp = P[popsize - 1];
+	P[popsize-1] = P[parent[1]];
+	P[parent[1]] = tmp;
+	popsize--;
+      }
+    }
+    /* mutation of a batch of candidates, evaluated at once; the
+       fitness of each lane is derived from a feasible parent's, so an
+       infeasible parent takes the path below */
+    else if (rs->batch > 1 && RUN_CALCULATE(P[parent[0]],ctx) >= 0){
+      chromosome* chr = P[parent[0]];
+      int rp = chr->fitness;
+      int rlane[BS_LANES];
+      size_t nflips[BS_LANES];
+      size_t j, l;
+      int best = -1;
+      lane_t ok;
+
+      /* every lane starts as a copy of parent 0 and gets its own flips */
+      bs_load(&rs->bs,chr,bs_lanes(rs->batch));
+      for (j=0; j<rs->batch; j++){
+	int* lflips = flips + j*setlen;
+	nflips[j] = mutation_positions(ctx,setlen,rs->mrate,lflips);
+	rlane[j] = rp;
+	for (l=0; l<nflips[j]; l++){
+	  bs_flip(&rs->bs,j,lflips[l]);
+	  rlane[j] += ps_read(&chr->S,lflips[l]) ? -1 : 1;
+	}
+      }
+      ok = bs_feasible(&rs->bs,G,ctx->k);
+      bs_clear(&rs->bs);
+
+      /* keep the smallest feasible mutant that dominates the parent */
+      for (j=0; j<rs->batch; j++){
+	if (((ok >> j) & 1) && rlane[j] <= rp && (best < 0 || rlane[j] < rlane[best])) best = j;
+      }
+      rs->mutations += rs->batch;
+      if (best >= 0){
+	for (l=0; l<nflips[best]; l++) chromosome_flip(chr,flips[best*setlen+l]);
+	chr->fitness = rlane[best];
+	rs->kept++;
+	if (rlane[best] < rp) rs->improved++;
+      }
+    }
+    /* mutation */
+    else {
+      /* mutation never changes V, so flip bits of parent 0 in place */
+      chromosome* chr = P[parent[0]];
+      int rp = RUN_CALCULATE(chr,ctx);
+      int ip = chr->inside;
+      size_t nflips = mutate(ctx,chr,rs->mrate,flips);
+
+      /* determine feasibility, unless this mutant was rejected
+	 recently (only rejections are trusted, so a hash collision
+	 can never let in an infeasible mutant); a feasible parent
+	 only needs the flipped elements checked */
+      key = chromosome_hash(chr);
+      if (tt_lookup(&rs->tt,key,&r) && r < 0){
+	chr->fitness = r;
+      }
+      else {
+	if (rp >= 0) r = RUN_MUTANT_FITNESS(chr,rp,ip,flips,nflips,ctx);
+	else r = RUN_CALCULATE(chr,ctx);
+	tt_store(&rs->tt,key,r);
+      }
+
+      /* offspring is kept if it is feasible and dominates parent,
+	 otherwise roll back the flips and the parent's fitness */
+      rs->mutations++;
+      if (r < 0 || r > rp){
+	flip_logged(chr,flips,nflips);
+	chr->fitness = rp;
+	chr->inside = ip;
+      }
+      else {
+	rs->kept++;
+	if (r < rp) rs->improved++;
+      }
+    }
+#ifdef ALLOC_DEBUG
+    if (alloc_count() != allocs){
+      fprintf(stderr,"ERROR: %lu allocations in generation %lu\n",alloc_count()-allocs,t);
+      exit(EXIT_FAILURE);
+    }
+#endif
+    if (++t >= rs->cutoff) break;
+    if (rs->adaptive && t % ADAPT_WINDOW == 0) adapt(rs,t);
+
+    /* races stop as soon as one run is solved, and islands migrate */
+    if (rs->stop && atomic_load_explicit(rs->stop,memory_order_relaxed)) break;
+    if (rs->inbox && t % MIGRATION_INTERVAL == 0){
+      rs->popsize = popsize;
+      rs->offspr = offspr;
+      migrate(rs);
+      popsize = rs->popsize;
+      offspr = rs->offspr;
+    }
+
+    if (popsize == 1) {
+      solved = true;
+      break;
+    }
+  }
+
+
+  rs->offspr = offspr;
+  rs->popsize = popsize;
+  rs->t = t;
+  rs->solved = solved;
+}
+
+/*
+ * Build and evaluate the offspring of the slots first, first+step, ...
+ * (a par_scan_fn, which never stops early). Each slot only reads the
+ * population, and works with its own context and scratch space.
+ */
+static bool RUN_SLOTS(int first, int step, void* arg, const atomic_bool* stop)
+{
+  run_state* rs = arg;
+  size_t s;
+  (void)stop;
+
+  for (s=first; s<rs->width; s+=step){
+    spec_slot* sl = &rs->slot[s];
+    context* ctx = sl->ctx;
+    const chromosome* p0 = rs->P[sl->parent[0]];
+    chromosome* offspr = sl->offspr;
+    uint64_t key;
+    int r;
+
+    if (sl->cross){
+      /* as in RUN_SOLVE, with the slot's table of rejections */
+      const chromosome* p1 = rs->P[sl->parent[1]];
+      chromosome_vmerge(offspr,p0,p1,ctx->G);
+      RUN_TEMPLATE(&sl->tau,offspr,p0,p1,ctx);
+      crossover(ctx,&offspr->S,&p0->S,&p1->S,&sl->tau);
+      chromosome_rehash(offspr);
+      key = chromosome_hash(offspr) ^ zobrist_key(chromosome_hash(p0) + chromosome_hash(p1));
+      if (!tt_lookup(&sl->tt,key,&r) || r >= 0){
+	r = RUN_REPAIR(offspr,&p0->S,&p1->S,&sl->tau,ctx);
+	if (r == FITNESS_UNKNOWN) r = RUN_CALCULATE(offspr,ctx);
+	if (r < 0 && (size_t)offspr->cached_Vlist_len <= rs->exact) r = fpt_solve(offspr,ctx->k,ctx);
+	tt_store(&sl->tt,key,r);
+      }
+    }
+    else {
+      /* the mutant is built on a copy, as the parent may be shared;
+	 as in RUN_SOLVE, only cached rejections are trusted */
+      size_t nflips;
+      chromosome_copy(offspr,p0);
+      nflips = mutate(ctx,offspr,rs->mrate,sl->flips);
+      key = chromosome_hash(offspr);
+      if (tt_lookup(&sl->tt,key,&r) && r < 0){
+	offspr->fitness = r;
+      }
+      else {
+	if (sl->rp >= 0) r = RUN_MUTANT_FITNESS(offspr,sl->rp,p0->inside,sl->flips,nflips,ctx);
+	else r = RUN_CALCULATE(offspr,ctx);
+	tt_store(&sl->tt,key,r);
+      }
+    }
+    sl->r = r;
+  }
+  return false;
+}
+
+/*
+ * Speculative generation loop: every round builds rs->width offspring
+ * from the population as it stands, evaluates them concurrently and
+ * commits them in slot order, each as one generation of RUN_SOLVE.
+ * A commit replaces or merges away its parents, so the later slots of
+ * the round that share one of them are discarded.
+ */
+static void RUN_SPECULATE(run_state* rs)
+{
+  context* ctx = rs->ctx;
+  chromosome** P = rs->P;
+  size_t width = rs->width;
+  size_t popsize = rs->popsize;
+  size_t t = rs->t;
+  bool solved = (popsize == 1);
+  bool migrate_due = false;
+  size_t s, j;
+#ifdef ALLOC_DEBUG
+  size_t allocs;
+#endif
+
+  while (popsize > 1 && t < rs->cutoff){
+#ifdef ALLOC_DEBUG
+    allocs = alloc_count();
+#endif
+    /* draw the parents and operator of every slot */
+    for (s=0; s<width; s++){
+      spec_slot* sl = &rs->slot[s];
+      pcg64_random_choose2(&ctx->rng,sl->parent,popsize);
+      sl->cross = pcg64_random_unif(&ctx->rng) < rs->pcross;
+      sl->consumed = false;
+      if (sl->cross && rs->select == SELECT_ADJACENT) select_adjacent(rs,sl->parent);
+      if (!sl->cross) sl->rp = RUN_CALCULATE(P[sl->parent[0]],ctx);
+    }
+
+    /* evaluate them */
+    if (ctx->pool) par_any(ctx->pool,RUN_SLOTS,rs);
+    else RUN_SLOTS(0,1,rs,NULL);
+
+    /* commit them in order */
+    for (s=0; s<width && popsize > 1 && t < rs->cutoff; s++){
+      spec_slot* sl = &rs->slot[s];
+      uint64_t a = sl->parent[0], b = sl->parent[1];
+      chromosome* tmp;
+
+      t++;
+      if (sl->consumed){
+	rs->discarded++;
+      }
+      else if (sl->cross){
+	rs->crossovers++;
+	if (sl->r >= 0){
+	  /* as in RUN_SOLVE: P[popsize-1] moves into the slot of b */
+	  rs->accepted++;
+	  if (rs->select == SELECT_ADJACENT) owners_merge(rs,a,b,popsize-1);
+	  tmp = P[a];
+	  P[a] = sl->offspr;
+	  sl->offspr = tmp;
+	  tmp = P[popsize - 1];
+	  P[popsize-1] = P[b];
+	  P[b] = tmp;
+	  popsize--;
+	  for (j=s+1; j<width; j++){
+	    spec_slot* later = &rs->slot[j];
+	    if (later->parent[0] == a || later->parent[0] == b) later->consumed = true;
+	    if (later->cross && (later->parent[1] == a || later->parent[1] == b)) later->consumed = true;
+	    if (later->parent[0] == popsize) later->parent[0] = b;
+	    if (later->parent[1] == popsize) later->parent[1] = b;
+	  }
+	}
+      }
+      else {
+	rs->mutations++;
+	if (sl->r >= 0 && sl->r <= sl->rp){
+	  rs->kept++;
+	  if (sl->r < sl->rp) rs->improved++;
+	  tmp = P[a];
+	  P[a] = sl->offspr;
+	  sl->offspr = tmp;
+	  for (j=s+1; j<width; j++){
+	    spec_slot* later = &rs->slot[j];
+	    if (later->parent[0] == a || (later->cross && later->parent[1] == a)) later->consumed = true;
+	  }
+	}
+      }
+      if (rs->adaptive && t % ADAPT_WINDOW == 0) adapt(rs,t);
+      if (rs->inbox && t % MIGRATION_INTERVAL == 0) migrate_due = true;
+    }
+#ifdef ALLOC_DEBUG
+    if (alloc_count() != allocs){
+      fprintf(stderr,"ERROR: %lu allocations in generation %lu\n",alloc_count()-allocs,t);
+      exit(EXIT_FAILURE);
+    }
+#endif
+
+    /* races stop as soon as one run is solved, and islands migrate */
+    if (rs->stop && atomic_load_explicit(rs->stop,memory_order_relaxed)) break;
+    if (migrate_due){
+      rs->popsize = popsize;
+      migrate(rs);
+      popsize = rs->popsize;
+      migrate_due = false;
+    }
+  }
+  if (popsize == 1) solved = true;
+
+  rs->popsize = popsize;
+  rs->t = t;
+  rs->solved = solved;
+}
+
+#undef RUN_SOLVE
+#undef RUN_SPECULATE
+#undef RUN_SLOTS
+#undef RUN_CALCULATE
+#undef RUN_FEASIBLE
+#undef RUN_REPAIR
+#undef RUN_TEMPLATE
+#undef RUN_MUTANT_FITNESS
@@ -12,93 +12,59 @@
 #include "chromosome.h"
 #include "cvd.h"
 #include "cd.h"
+#include "cep.h"
+#include "fpt.h"
 #include "params.h"
-
-static pcg64_random_t rng;
-
-/* Standard uniform mutation */
-void mutate(packed_set* x,double rate)
-{
-  size_t i = pcg64_random_geom(&rng,rate) - 1;
-  while (i < x->capacity){
-    ps_flip(x,i);
-    i += pcg64_random_geom(&rng,rate);
-  }    
-}
-
-/* Uniform 3-way crossover */
-void crossover(packed_set* x, packed_set* p1, packed_set* p2, packed_set* p3)
-{
-  size_t i;
-  packed_set* parents[3] = {p1,p2,p3};
-  assert(x->capacity == p1->capacity && p1->capacity == p2->capacity);
-  ps_zero(x);
-  for (i =0; i<x->capacity; i++){    
-    ps_copy_bit(x,parents[pcg64_random_bounded(&rng,3)],i);
-  }
-}
-
-/* Select two distinct elements of [0,n) */
-void select2(int* a, int* b, int n)
-{
-  assert(n > 1);
-  if (n == 2){
-    *a = pcg64_random_fast(&rng) % 2;
-    *b = 1 - *a;
-  }
-  else {
-    *a = pcg64_random_bounded(&rng,n);
-    do {
-      *b = pcg64_random_bounded(&rng,n);
-    } while (*a == *b);
-  }
-}
-  
-/* Return how many elements in set, otherwise -1 if not feasible */
-int calculate(chromosome* chr, graph_data*G, bool (*feasible)(const chromosome*, const graph_data*))
-{
-  if (!feasible(chr,G)) return -1;
-  return ps_popcount(&chr->S);
-}
-
+#include "ttable.h"
+#include "bitslice.h"
+#include "context.h"
+#include "run.h"
+#include "race.h"
+#include "island.h"
+#include "portfolio.h"
+#include "sweep.h"
+#include "minimize.h"
 
 int main(int argc, char** argv)
 {
   params prm;
   char* typestr;
   int i;
-  size_t t, popsize, setlen;
   graph_data G;
-  chromosome** P;
-  chromosome offspr;
-  packed_set tau;
+  run_state single;
+  run_state* rs;
+  const params* rprm = &prm;
+  islands is;
+  portfolio pf;
+  sweep sw;
+  minimize_result mr;
+  const packed_set* solution;
+  race* r = NULL;
+  int best = 0;
+  witness_cache wc;
+  fpt_stats fs;
+  size_t tt_lookups, tt_hits;
   FILE* file;
-  bool solved=false;
-  size_t cutoff = 0;
-  
-  /* function pointers */
-  bool (*feasible)(const chromosome*, const graph_data*);
-  bool (*repair)(chromosome*, const packed_set*, const packed_set*, const packed_set*, const graph_data*);
-  void (*template)(packed_set*, const chromosome*, const chromosome*, const chromosome*, const graph_data*);
 
 
   /* set parameters from command line arguments */
   set_params_from_args(&prm,argc,argv);
 
 
+  check_params(&prm);
+  if (prm.portfolio_len > 0) portfolio_init(&pf,&prm);
+  if (sweep_requested(&prm)) sweep_init(&sw,&prm);
+
   switch(prm.type){
   case CVD:
-    feasible = &cvd_feasible;
-    repair = &cvd_repair;
-    template = &cvd_template;
     typestr="cvd";
     break;
   case CD:
-    feasible = &cd_feasible;
-    repair = &cd_repair;
-    template = &cd_template;
     typestr="cd";
     break;
+  case CEP:
+    typestr="cep";
+    break;
   default:
     perror(strerror(ENOSYS));
     exit(EXIT_FAILURE);
@@ -115,107 +81,124 @@ int main(int argc, char** argv)
   fclose(file);
  
   fprintf(stderr,"Loaded a graph with %d vertices and %d edges\n",G.n,G.m);
-  popsize = G.n;
+  if (prm.type == CEP){
+    index_nonedges(&G);
+    fprintf(stderr,"Indexed %d non-edges in P3s as candidate insertions\n",G.q);
+  }
   G.k = prm.k;
-  cutoff = prm.cutoff;
-  if (prm.type == CVD) setlen = G.n;
-  if (prm.type == CD) setlen = G.m;
-    
-  /* seed random number generator */
-  fprintf(stderr,"Seeding random number generator...\n");
-  pcg64_getentropy(&rng);
 
-  /* initialize population */
+  /* a sweep runs its jobs on this graph and writes a result line for each */
+  if (sweep_requested(&prm)){
+    fprintf(stderr,"Sweeping %lu jobs, %lu at a time\n",sw.len,prm.sweep_threads);
+    sweep_run(&sw,&G,&prm,typestr,stdout);
+    sweep_free(&sw);
+    free_graph(&G);
+    return EXIT_SUCCESS;
+  }
+    
+  /* initialize population (this seeds the random number generator) */
   fprintf(stderr,"Initializing population...\n");
-  P = malloc(popsize*sizeof(chromosome*));
-  for (i=0; i<G.n; i++){
-    P[i] = malloc(sizeof(chromosome));
-    chromosome_init(P[i],setlen,G.n);
-    chromosome_seed(P[i],i);
-    ps_randomize(&P[i]->S,&rng);
+  if (prm.portfolio_len > 0){
+    portfolio_start(&pf,&G);
+    r = &pf.r;
+  }
+  else if (prm.islands > 1){
+    islands_init(&is,&G,&prm,prm.islands);
+    r = &is.r;
+  }
+  else {
+    run_init(&single,&G,&prm,0);
+    context_parallel(single.ctx,prm.threads);
   }
-  chromosome_init(&offspr,setlen,G.n);
-  ps_init(&tau,setlen);
+  rs = r ? &r->rs[0] : &single;
+  if (rs->greedy >= 0) fprintf(stderr,"Seeded from a greedy solution of size %d\n",rs->greedy);
+  if (rs->presolved > 0) fprintf(stderr,"Solved %lu small components exactly\n",rs->presolved);
 
-  fprintf(stderr,"Starting run with n=%d, k=%d, popsize=%lu, cutoff=%lu\n",G.n,G.k,popsize,cutoff);
+  fprintf(stderr,"Starting run with n=%d, k=%d, popsize=%lu, cutoff=%lu\n",G.n,G.k,rs->popsize,rs->cutoff);
 
   /* main loop */
-  t = 0;
-  while( popsize > 1){
-    uint64_t parent[2];
-    int r;
-
-    /* choose parents */
-    pcg64_random_choose2(&rng,parent,popsize);
-
-    /* crossover */
-    if (pcg64_random_unif(&rng) < 0.8){
-
-      /* offspring vertex set is union of parent vertex sets */
-      chromosome_vmerge(&offspr,P[parent[0]],P[parent[1]]);
-
-      /* compute template parent */
-      template(&tau,&offspr,P[parent[0]],P[parent[1]],&G);
-
-      /* 3-way uniform crossover */
-      crossover(&offspr.S,&P[parent[0]]->S,&P[parent[1]]->S,&tau);
-
-      /* repair operator */
-      repair(&offspr,&P[parent[0]]->S,&P[parent[1]]->S,&tau,&G);
-
-      /* determine feasibility */
-      r = calculate(&offspr,&G,feasible);
-
-      if (r >= 0) {
-	/* offspring was feasible, it must dominate both parents */
-	chromosome_copy(P[parent[0]],&offspr);
-	chromosome* tmp = P[popsize - 1];
-	P[popsize-1] = P[parent[1]];
-	P[parent[1]] = tmp;
-	popsize--;
-      }
-    }
-    /* mutation */
-    else {
-      /* copy and flip each bit of parent 0 to create offspring */
-      chromosome_copy(&offspr,P[parent[0]]);     
-      mutate(&offspr.S,1.0/setlen);
-
-      /* determine feasibility */
-      r = calculate(&offspr,&G,feasible);
-      
-      if (r >= 0 && r <= calculate(P[parent[0]],&G,feasible)){
-	/* offspring was feasible and dominates parent */
-	chromosome_copy(P[parent[0]],&offspr);
-      }      
+  if (r){
+    race_run(r);
+    best = race_best(r);
+    rs = &r->rs[best];
+  }
+  else if (prm.minimize) minimize(rs,&prm,typestr,stdout,&mr);
+  else run_solve(rs);
+  solution = rs->solved ? &rs->P[0]->S : NULL;
+
+  if (prm.minimize){
+    solution = (mr.best >= 0) ? &mr.S : NULL;
+    if (mr.best < 0) fprintf(stderr,"Minimize: no solution within k=%d\n",G.k);
+    else fprintf(stderr,"Minimize: smallest solution of size %d in %d attempts%s\n",mr.best,mr.attempts,
+		 mr.best <= mr.lower ? ", optimal (at the lower bound)" : "");
+  }
+  if (prm.portfolio_len > 0){
+    rprm = &pf.prm[best];
+    for (i=0; i<r->count; i++){
+      run_state* ri = &r->rs[i];
+      fprintf(stderr,"Configuration %d '%s': %s after %lu generations in %.2fs, popsize %lu\n",i,prm.portfolio[i],
+	      ri->solved ? "solved" : ri->t < ri->cutoff ? "cancelled" : "cutoff reached",ri->t,r->seconds[i],ri->popsize);
     }
-    if (++t >= cutoff) break;
-    
-    if (popsize == 1) {
-      solved = true;
-      break;
+    fprintf(stderr,"Portfolio: configuration %d '%s' %s\n",best,prm.portfolio[best],
+	    rs->solved ? "won" : "has the smallest population");
+  }
+  if (prm.islands > 1){
+    size_t sent = 0, dropped = 0, immigrants = 0;
+    for (i=0; i<r->count; i++){
+      sent += is.queue[i].sent;
+      dropped += is.queue[i].dropped;
+      immigrants += r->rs[i].immigrants;
     }
+    fprintf(stderr,"Islands: %d, island %d %s; %lu migrants sent, %lu dropped (queue full), %lu taken in\n",
+	    r->count,best,rs->solved ? "solved" : "has the smallest population",sent,dropped,immigrants);
   }
 
-  /* output results */
-  fprintf(stdout,"%s,%d,%d,%d,%s,%lu,%d,%lu,%lu\n",prm.input_filename,G.n,G.m,G.k,typestr,t,solved,popsize,cutoff);
+  fprintf(stderr,"Crossover (%s selection): %lu of %lu offspring accepted (%.1f%%)\n",select_name(rs->select),
+	  rs->accepted,rs->crossovers,rs->crossovers ? 100.0*rs->accepted/rs->crossovers : 0.0);
+  fprintf(stderr,"Mutation: %lu of %lu mutants kept (%.1f%%), %lu smaller than their parent\n",
+	  rs->kept,rs->mutations,rs->mutations ? 100.0*rs->kept/rs->mutations : 0.0,rs->improved);
+  if (rs->width > 1){
+    fprintf(stderr,"Speculation: %lu offspring at once, %lu discarded (a parent was consumed by an earlier commit)\n",
+	    rs->width,rs->discarded);
+  }
+  run_statistics(rs,&tt_lookups,&tt_hits,&wc,&fs);
+  fprintf(stderr,"Transposition table: %lu hits in %lu lookups (%.1f%%)\n",
+	  tt_hits,tt_lookups,tt_lookups ? 100.0*tt_hits/tt_lookups : 0.0);
+  if (prm.type == CVD || prm.type == CD){
+    fprintf(stderr,"Witness cache: %lu hits in %lu lookups, %lu rejections (%.1f%% of rejections)\n",
+	    wc.hits,wc.lookups,wc.rejections,wc.rejections ? 100.0*wc.hits/wc.rejections : 0.0);
+  }
+  if (rprm->exact > 0){
+    fprintf(stderr,"Exact solver: %lu solved in %lu calls (%lu at the node limit), %lu search tree nodes\n",
+	    fs.solved,fs.calls,fs.aborted,fs.nodes);
+  }
+
+  /* output results (the search for the smallest k wrote one per attempt) */
+  if (!prm.minimize) fprintf(stdout,"%s,%d,%d,%d,%s,%lu,%d,%lu,%lu\n",prm.input_filename,G.n,G.m,G.k,typestr,rs->t,rs->solved,rs->popsize,rs->cutoff);
 
   /* save solution if requested */
-  if (solved && prm.save_solution){
+  if (solution && prm.save_solution){
     FILE* save_chr = fopen(prm.solution_filename,"w");
     if (!save_chr) {
       fprintf(stderr, "ERROR: fopen failed for '%s' (%s)\n", prm.solution_filename, strerror(errno));
     }
     else{
-      int* A = malloc(ps_capacity(&P[0]->S)*sizeof(int));
+      int* A = malloc(ps_capacity(solution)*sizeof(int));
       int len;
-      ps_contents(A,&len,&P[0]->S);
+      ps_contents(A,&len,solution);
       if (prm.type == CVD){
 	for (i=0; i<len; i++) fprintf(save_chr,"%d\n",A[i]);
       }
       else if (prm.type == CD){
 	for (i=0; i<len; i++) fprintf(save_chr,"%d %d\n",src(G.edge_list[A[i]]),snk(G.edge_list[A[i]]));
       }
+      else if (prm.type == CEP){
+	/* signed edits: -u v deletes edge uv, +u v inserts it */
+	for (i=0; i<len; i++){
+	  if (A[i] < G.m) fprintf(save_chr,"-%d %d\n",src(G.edge_list[A[i]]),snk(G.edge_list[A[i]]));
+	  else fprintf(save_chr,"+%d %d\n",src(G.nonedge_list[A[i]-G.m]),snk(G.nonedge_list[A[i]-G.m]));
+	}
+      }
       else {
 	perror(strerror(ENOSYS));
 	exit(EXIT_FAILURE);
@@ -226,14 +209,17 @@ int main(int argc, char** argv)
   }
   
   //fprintf(stderr, "++++++++++ FINAL POPULATION ++++++++++\n");
-  if (!solved){
+  if (!rs->solved && !prm.minimize){
     fprintf(stderr,"Unsolved; final population\n");
-    for (i=0; i<(int)popsize; i++){
-      chromosome_debug(P[i]);
+    for (i=0; i<(int)rs->popsize; i++){
+      chromosome_debug(rs->P[i]);
     }
   }
 
-  ps_free(&tau);
+  if (prm.portfolio_len > 0) portfolio_free(&pf);
+  else if (prm.islands > 1) islands_free(&is);
+  else run_free(&single);
+  if (prm.minimize) minimize_free(&mr);
   free_graph(&G);
   
 
@@ -0,0 +1,206 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "graph.h"
+#include "params.h"
+#include "context.h"
+#include "parallel.h"
+#include "alloc_debug.h"
+#include "run.h"
+#include "sweep.h"
+
+/* Is prm a sweep? */
+bool sweep_requested(const params* prm)
+{
+  return prm->sweep_k || prm->sweep_seeds || prm->manifest;
+}
+
+/*
+ * Parse a comma-separated list of numbers into list (allocated), and
+ * return its length; exits if the list is malformed
+ */
+static size_t parse_list(const char* str, uint64_t** list, const char* what)
+{
+  size_t len = 1;
+  const char* p;
+  char* end;
+
+  for (p=str; *p; p++) if (*p == ',') len++;
+  *list = malloc(len*sizeof(uint64_t));
+  for (len=0, p=str;; p=end+1){
+    (*list)[len++] = strtoull(p,&end,10);
+    if (end == p || (*end != ',' && *end != '\0')){
+      fprintf(stderr,"ERROR: malformed list of %s '%s'\n",what,str);
+      exit(EXIT_FAILURE);
+    }
+    if (*end == '\0') return len;
+  }
+}
+
+/* Add a job for base with budget k and the given seed */
+static void add_job(sweep* sw, size_t* capacity, const params* base, int k, uint64_t seed, bool seeded)
+{
+  sweep_job* j;
+  if (sw->len == *capacity){
+    *capacity = 2*(*capacity) + 1;
+    sw->job = realloc(sw->job,*capacity*sizeof(sweep_job));
+  }
+  j = &sw->job[sw->len++];
+  j->prm = *base;
+  j->prm.k = k;
+  j->prm.seed = seed;
+  j->prm.seeded = seeded;
+  j->done = false;
+}
+
+/* Read the jobs of the sweep set by base (exits on malformed lists) */
+void sweep_init(sweep* sw, const params* base)
+{
+  size_t capacity = 0;
+
+  sw->job = NULL;
+  sw->len = 0;
+  if (base->manifest){
+    FILE* file = fopen(base->manifest,"r");
+    char line[256];
+    int lineno = 0;
+    if (file == NULL){
+      fprintf(stderr,"ERROR: unable to open sweep manifest '%s'\n",base->manifest);
+      exit(EXIT_FAILURE);
+    }
+    while (fgets(line,sizeof(line),file)){
+      int k;
+      unsigned long long seed;
+      char c;
+      lineno++;
+      if (sscanf(line," %c",&c) != 1 || c == '#') continue;
+      if (sscanf(line,"%d %llu",&k,&seed) != 2 || k <= 0){
+	fprintf(stderr,"ERROR: malformed line %d of sweep manifest '%s'\n",lineno,base->manifest);
+	exit(EXIT_FAILURE);
+      }
+      add_job(sw,&capacity,base,k,seed,true);
+    }
+    fclose(file);
+  }
+  else {
+    uint64_t* ks = NULL;
+    uint64_t* seeds = NULL;
+    size_t nk = 1, nseeds = 1, a, b;
+    if (base->sweep_k) nk = parse_list(base->sweep_k,&ks,"k values");
+    if (base->sweep_seeds) nseeds = parse_list(base->sweep_seeds,&seeds,"seeds");
+    for (a=0; a<nk; a++){
+      int k = ks ? (int)ks[a] : (int)base->k;
+      if (k <= 0){
+	fprintf(stderr,"ERROR: k value %d in '%s'\n",k,base->sweep_k);
+	exit(EXIT_FAILURE);
+      }
+      for (b=0; b<nseeds; b++){
+	if (seeds) add_job(sw,&capacity,base,k,seeds[b],true);
+	else add_job(sw,&capacity,base,k,base->seed,base->seeded);
+      }
+    }
+    free(ks);
+    free(seeds);
+  }
+  if (sw->len == 0){
+    fprintf(stderr,"ERROR: the sweep has no jobs\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Free the jobs */
+void sweep_free(sweep* sw)
+{
+  free(sw->job);
+}
+
+/* Seconds on the monotonic clock */
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+/*
+ * Record that job i is done, and write the result lines now in order.
+ * They keep the single-run format; the job's seed is on its stderr
+ * line.
+ */
+static void finish(sweep* sw, size_t i)
+{
+  pthread_mutex_lock(&sw->lock);
+  sw->job[i].done = true;
+  while (sw->printed < sw->len && sw->job[sw->printed].done){
+    const sweep_job* j = &sw->job[sw->printed];
+    if (j->prm.seeded) fprintf(stderr,"Job %lu (k=%lu, seed %llu): ",sw->printed,j->prm.k,(unsigned long long)j->prm.seed);
+    else fprintf(stderr,"Job %lu (k=%lu): ",sw->printed,j->prm.k);
+    fprintf(stderr,"%s after %lu generations in %.2fs\n",j->solved ? "solved" : "unsolved",j->t,j->seconds);
+    fprintf(sw->out,"%s,%d,%d,%lu,%s,%lu,%d,%lu,%lu\n",j->prm.input_filename,sw->G->n,sw->G->m,j->prm.k,
+	    sw->typestr,j->t,j->solved,j->popsize,j->prm.cutoff);
+    fflush(sw->out);
+    sw->printed++;
+  }
+  pthread_mutex_unlock(&sw->lock);
+}
+
+/*
+ * Take jobs until none are left (a par_scan_fn: every thread of the
+ * pool pulls from the same counter, so long jobs do not hold up the
+ * others)
+ */
+static bool sweep_worker(int first, int step, void* arg, const atomic_bool* stop)
+{
+  sweep* sw = arg;
+  size_t i;
+  (void)first;
+  (void)step;
+  (void)stop;
+
+#ifdef ALLOC_DEBUG
+  /* jobs run side by side, so each thread checks only its own */
+  alloc_charge(NULL);
+#endif
+  while ((i = atomic_fetch_add(&sw->next,1)) < sw->len){
+    sweep_job* j = &sw->job[i];
+    run_state rs;
+    double start = now();
+    run_init(&rs,sw->G,&j->prm,0);
+    context_parallel(rs.ctx,j->prm.threads);
+    run_solve(&rs);
+    j->t = rs.t;
+    j->solved = rs.solved;
+    j->popsize = rs.popsize;
+    j->seconds = now() - start;
+    run_free(&rs);
+    finish(sw,i);
+  }
+  return false;
+}
+
+/*
+ * Run the jobs on G, base->sweep_threads at a time, writing their
+ * result lines (type is the problem's name) to out
+ */
+void sweep_run(sweep* sw, const graph_data* G, const params* base, const char* typestr, FILE* out)
+{
+  sw->G = G;
+  sw->typestr = typestr;
+  sw->out = out;
+  sw->printed = 0;
+  atomic_init(&sw->next,0);
+  pthread_mutex_init(&sw->lock,NULL);
+  if (base->sweep_threads > 1){
+    par_pool* pool = par_create(base->sweep_threads);
+    par_any(pool,sweep_worker,sw);
+    par_destroy(pool);
+  }
+  else sweep_worker(0,1,sw,NULL);
+  pthread_mutex_destroy(&sw->lock);
+}
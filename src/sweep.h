@@ -0,0 +1,64 @@
+/*
+ * Sweep: runs of the same settings on one loaded graph for a list of
+ * (k, seed) jobs, several at once, printing a result line per job
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "graph.h"
+#include "params.h"
+
+/*
+ * A job: the settings of its run, and once it has ended its result
+ * (generations, whether it was solved, final population size) and the
+ * wall clock time it took
+ */
+typedef struct {
+  params prm;
+  size_t t;
+  bool solved;
+  size_t popsize;
+  double seconds;
+  bool done;
+} sweep_job;
+
+/*
+ * job[0..len-1] are the jobs, next the first one no thread has taken
+ * yet and printed the number of result lines written; the lines are
+ * written in job order, each as soon as the jobs before it are done
+ */
+typedef struct {
+  const graph_data* G;
+  const char* typestr;
+  sweep_job* job;
+  size_t len;
+  atomic_size_t next;
+  size_t printed;
+  pthread_mutex_t lock;
+  FILE* out;
+} sweep;
+
+/* Is prm a sweep? */
+bool sweep_requested(const params* prm);
+
+/* Read the jobs of the sweep set by base (exits on malformed lists) */
+void sweep_init(sweep* sw, const params* base);
+
+/* Free the jobs */
+void sweep_free(sweep* sw);
+
+/*
+ * Run the jobs on G, base->sweep_threads at a time, writing their
+ * result lines (type is the problem's name) to out
+ */
+void sweep_run(sweep* sw, const graph_data* G, const params* base, const char* typestr, FILE* out);
+
+#endif
@@ -0,0 +1,62 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "ttable.h"
+
+/* splitmix64 finalizer, so keys need no storage */
+uint64_t zobrist_key(uint64_t x)
+{
+  uint64_t z = (x + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/* Initialize a table with 2^log2size entries */
+void tt_init(ttable* tt, int log2size)
+{
+  size_t size = (size_t)1 << log2size;
+  assert(log2size > 0);
+  tt->keys = calloc(size,sizeof(uint64_t));
+  tt->values = calloc(size,sizeof(int));
+  tt->mask = size - 1;
+  tt->lookups = tt->hits = 0;
+}
+
+/* Free memory */
+void tt_free(ttable* tt)
+{
+  free(tt->keys);
+  free(tt->values);
+  tt->mask = 0;
+}
+
+/* Look up key, storing the associated value in value on success */
+bool tt_lookup(ttable* tt, uint64_t key, int* value)
+{
+  size_t slot = key & tt->mask;
+  tt->lookups++;
+  if (key != 0 && tt->keys[slot] == key){
+    *value = tt->values[slot];
+    tt->hits++;
+    return true;
+  }
+  return false;
+}
+
+/* Store value for key, replacing whatever occupied its slot */
+void tt_store(ttable* tt, uint64_t key, int value)
+{
+  size_t slot = key & tt->mask;
+  tt->keys[slot] = key;
+  tt->values[slot] = value;
+}
+
+/* Empty the table (keeping its statistics) */
+void tt_clear(ttable* tt)
+{
+  memset(tt->keys,0,(tt->mask+1)*sizeof(uint64_t));
+}
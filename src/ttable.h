@@ -0,0 +1,50 @@
+/*
+ * Zobrist hashing of chromosomes and a bounded transposition table of
+ * recently evaluated offspring
+ */
+
+#ifndef TTABLE_H
+#define TTABLE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 
+ * Keys for the elements of the solution set S and of the vertex set V
+ * (the hash of a chromosome is the xor of the keys of its elements)
+ */
+#define zobrist_S(I) zobrist_key(2*(uint64_t)(I))
+#define zobrist_V(I) zobrist_key(2*(uint64_t)(I)+1)
+
+/* 
+ * Direct-mapped table of (hash, value) entries. A key of zero marks an
+ * empty slot.
+ */
+typedef struct {
+  uint64_t* keys;
+  int* values;
+  size_t mask;
+  size_t lookups;
+  size_t hits;
+} ttable;
+
+/* Pseudorandom 64-bit key for integer x */
+uint64_t zobrist_key(uint64_t x);
+
+/* Initialize a table with 2^log2size entries */
+void tt_init(ttable* tt, int log2size);
+
+/* Free memory */
+void tt_free(ttable* tt);
+
+/* Look up key, storing the associated value in value on success */
+bool tt_lookup(ttable* tt, uint64_t key, int* value);
+
+/* Store value for key, replacing whatever occupied its slot */
+void tt_store(ttable* tt, uint64_t key, int value);
+
+/* Empty the table (keeping its statistics) */
+void tt_clear(ttable* tt);
+
+#endif
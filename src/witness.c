@@ -0,0 +1,20 @@
+#include <stdlib.h>
+
+#include "witness.h"
+
+/* Empty the cache and reset its statistics */
+void wc_clear(witness_cache* wc)
+{
+  wc->len = wc->next = 0;
+  wc->lookups = wc->rejections = wc->hits = 0;
+}
+
+/* Record a witness, replacing the oldest one if the cache is full */
+void wc_store(witness_cache* wc, int x, int y, int z)
+{
+  wc->x[wc->next] = x;
+  wc->y[wc->next] = y;
+  wc->z[wc->next] = z;
+  wc->next = (wc->next + 1) % WITNESS_SLOTS;
+  if (wc->len < WITNESS_SLOTS) wc->len++;
+}
@@ -0,0 +1,35 @@
+/*
+ * Small cache of recently found witnesses of infeasibility (P3s),
+ * checked before a full scan since the same few P3s tend to reject
+ * offspring over and over
+ */
+
+#ifndef WITNESS_H
+#define WITNESS_H
+
+#include <stdlib.h>
+
+#define WITNESS_SLOTS 8
+
+/*
+ * Witness i is the triple (x[i],y[i],z[i]); its meaning is up to the
+ * problem type. lookups counts the checks made, rejections the checks
+ * that found a violation and hits those found by a cached witness.
+ */
+typedef struct {
+  int x[WITNESS_SLOTS];
+  int y[WITNESS_SLOTS];
+  int z[WITNESS_SLOTS];
+  int len, next;
+  size_t lookups;
+  size_t rejections;
+  size_t hits;
+} witness_cache;
+
+/* Empty the cache and reset its statistics */
+void wc_clear(witness_cache* wc);
+
+/* Record a witness, replacing the oldest one if the cache is full */
+void wc_store(witness_cache* wc, int x, int y, int z);
+
+#endif